@@ -0,0 +1,73 @@
+--****
+-- === bench/cmpbench.ex
+--
+-- Times ##compare##() and ##equal##() on pairs of equal sequences of
+-- integers of different sizes, and on pairs that differ only in their
+-- last element.
+--
+-- ==== Usage
+-- {{{
+--     eui cmpbench [size ...]
+-- }}}
+--
+-- Sizes default to 1_000, 100_000 and 10_000_000. Each comparison is
+-- repeated until it has taken at least a quarter of a second, and the time
+-- of one comparison is shown in microseconds.
+--
+
+include std/convert.e
+
+constant MIN_TIME = 0.25
+
+-- microseconds per compare(a, b), or equal(a, b) if eq isn't 0
+function time_compare(sequence a, sequence b, integer eq = 0)
+	integer n = 0, reps = 1
+	atom t, elapsed
+
+	while 1 do
+		t = time()
+		if eq then
+			for i = 1 to reps do
+				n += equal(a, b)
+			end for
+		else
+			for i = 1 to reps do
+				n += compare(a, b)
+			end for
+		end if
+		elapsed = time() - t
+		if elapsed >= MIN_TIME then
+			exit
+		end if
+		reps *= 2
+	end while
+	return elapsed / reps * 1e6
+end function
+
+sequence args = command_line(), sizes = {}
+for i = 3 to length(args) do
+	sizes &= to_integer(args[i], 1000)
+end for
+if length(sizes) = 0 then
+	sizes = { 1_000, 100_000, 10_000_000 }
+end if
+
+puts(1, "                  equal            differ at the end\n")
+puts(1, "      size    compare      equal    compare      equal\n")
+for i = 1 to length(sizes) do
+	integer n = sizes[i]
+	-- two separate sequences, so the elements are compared, not the pointers
+	sequence a = repeat(0, n), b = repeat(0, n)
+	for j = 1 to n do
+		a[j] = and_bits(j, #FF)
+		b[j] = a[j]
+	end for
+	sequence c = b
+	c[n] = -1
+	printf(1, "%10d %10.2f %10.2f %10.2f %10.2f\n", {
+		n,
+		time_compare(a, b),
+		time_compare(a, b, 1),
+		time_compare(a, c),
+		time_compare(a, c, 1) })
+end for
@@ -0,0 +1,78 @@
+--****
+-- === bench/eucjobs.ex
+--
+-- Times the translator building the Euphoria interpreter from its own
+-- sources, compiling with different numbers of parallel compiler processes.
+--
+-- ==== Usage
+-- {{{
+--     eui eucjobs [jobs ...]
+-- }}}
+--
+-- With no arguments it tries 1 job, then doubles up to one per processor.
+-- Run it from ##demo/bench## in a source checkout; ##euc## must be on the path.
+-- The translated interpreter is built in a scratch directory that is
+-- removed afterwards.
+--
+
+include std/convert.e
+include std/filesys.e
+include std/io.e
+include std/os.e
+include std/search.e
+
+constant
+	SOURCE = canonical_path("../../source/eui.ex"),
+	BUILD_DIR = canonical_path("eucjobs-build") & SLASH
+
+function cores()
+	ifdef WINDOWS then
+		return to_integer(getenv("NUMBER_OF_PROCESSORS"), 1)
+	elsedef
+		sequence lines = read_lines("/proc/cpuinfo")
+		integer n = 0
+		for i = 1 to length(lines) do
+			if begins("processor", lines[i]) then
+				n += 1
+			end if
+		end for
+		if n = 0 then
+			n = 1
+		end if
+		return n
+	end ifdef
+end function
+
+sequence args = command_line(), jobs = {}
+for i = 3 to length(args) do
+	jobs &= to_integer(args[i], 1)
+end for
+if length(jobs) = 0 then
+	integer n = 1
+	while n < cores() do
+		jobs &= n
+		n *= 2
+	end while
+	jobs &= cores()
+end if
+
+if not file_exists(SOURCE) then
+	puts(2, "Can't find " & SOURCE & ", run this from demo/bench\n")
+	abort(1)
+end if
+
+printf(1, "Translating and compiling %s\n\n", { SOURCE })
+puts(1, "jobs    seconds\n")
+for i = 1 to length(jobs) do
+	create_directory(BUILD_DIR)
+	atom t = time()
+	integer status = system_exec(sprintf(`euc -silent -jobs %d -build-dir "%s" -o "%seui" "%s"`,
+		{ jobs[i], BUILD_DIR, BUILD_DIR, SOURCE }), 2)
+	t = time() - t
+	remove_directory(BUILD_DIR, 1)
+	if status != 0 then
+		printf(2, "euc failed with status %d\n", status)
+		abort(1)
+	end if
+	printf(1, "%4d %10.2f\n", { jobs[i], t })
+end for
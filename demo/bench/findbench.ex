@@ -0,0 +1,76 @@
+--****
+-- === bench/findbench.ex
+--
+-- Times ##find##(), with and without a start position, on sequences of
+-- integers of different sizes, with the item found at the start, in the
+-- middle, at the end or not at all.
+--
+-- ==== Usage
+-- {{{
+--     eui findbench [size ...]
+-- }}}
+--
+-- Sizes default to 1_000, 100_000 and 10_000_000. Each search is repeated
+-- until it has taken at least a quarter of a second, and the time of one
+-- search is shown in microseconds. The last line searches a sequence that
+-- has a double in the middle, which has to be compared element by element.
+--
+
+include std/convert.e
+
+constant MIN_TIME = 0.25
+
+-- microseconds per find(x, s), or find(x, s, from) if from isn't 0
+function time_find(object x, sequence s, integer from = 0)
+	integer n = 0, reps = 1
+	atom t, elapsed
+
+	while 1 do
+		t = time()
+		if from then
+			for i = 1 to reps do
+				n += find(x, s, from)
+			end for
+		else
+			for i = 1 to reps do
+				n += find(x, s)
+			end for
+		end if
+		elapsed = time() - t
+		if elapsed >= MIN_TIME then
+			exit
+		end if
+		reps *= 2
+	end while
+	return elapsed / reps * 1e6
+end function
+
+sequence args = command_line(), sizes = {}
+for i = 3 to length(args) do
+	sizes &= to_integer(args[i], 1000)
+end for
+if length(sizes) = 0 then
+	sizes = { 1_000, 100_000, 10_000_000 }
+end if
+
+puts(1, "      size      start     middle        end    missing      from middle\n")
+for i = 1 to length(sizes) do
+	integer n = sizes[i]
+	sequence s = repeat(0, n)
+	for j = 1 to n do
+		s[j] = j
+	end for
+	printf(1, "%10d %10.2f %10.2f %10.2f %10.2f %10.2f\n", {
+		n,
+		time_find(1, s),
+		time_find(floor(n / 2), s),
+		time_find(n, s),
+		time_find(-1, s),
+		time_find(n, s, floor(n / 2)) })
+end for
+
+integer n = sizes[$]
+sequence s = repeat(0, n)
+s[floor(n / 2)] = 0.5
+printf(1, "\n%d zeros with a double in the middle, missing: %.2f\n",
+	{ n, time_find(1, s) })
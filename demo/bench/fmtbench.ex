@@ -0,0 +1,70 @@
+--****
+-- === bench/fmtbench.ex
+--
+-- Times turning atoms into text: ##sprint##() and ##print##() to a file, which
+-- show the fewest digits that read back as the same atom, against
+-- ##sprintf##() with the ##"%.10g"## format they used before.
+--
+-- ==== Usage
+-- {{{
+--     eui fmtbench [count]
+-- }}}
+--
+-- ##count## atoms, 1_000_000 by default, are formatted with each method: short
+-- decimals like prices, which need a few digits, and quotients, which need
+-- all of them. The output of ##print##() goes to a temporary file that is
+-- removed afterwards. The rate is shown in atoms per second.
+--
+
+include std/convert.e
+include std/filesys.e
+include std/rand.e
+
+sequence args = command_line()
+integer count = 1_000_000
+if length(args) >= 3 then
+	count = to_integer(args[3], count)
+end if
+
+set_rand(1)
+sequence short = repeat(0, count), long = repeat(0, count)
+for i = 1 to count do
+	short[i] = rand(1_000_000) / 100 + 0.005
+	long[i] = rand(1_000_000) / (rand(999) + 1.5)
+end for
+
+constant TEMP = temp_file(, "fmt", "txt")
+
+procedure report(sequence name, atom t)
+	printf(1, "%-26s %12d\n", { name, floor(count / t) })
+end procedure
+
+procedure bench(sequence name, sequence data)
+	atom t
+	sequence s
+
+	printf(1, "\n%s\n", { name })
+
+	t = time()
+	for i = 1 to count do
+		s = sprint(data[i])
+	end for
+	report("sprint", time() - t)
+
+	t = time()
+	for i = 1 to count do
+		s = sprintf("%.10g", data[i])
+	end for
+	report("sprintf(\"%.10g\")", time() - t)
+
+	integer fn = open(TEMP, "w")
+	t = time()
+	print(fn, data)
+	close(fn)
+	report("print of the sequence", time() - t)
+end procedure
+
+puts(1, "                           atoms/second\n")
+bench("short decimals", short)
+bench("quotients", long)
+delete_file(TEMP)
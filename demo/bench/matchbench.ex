@@ -0,0 +1,73 @@
+--****
+-- === bench/matchbench.ex
+--
+-- Times ##match##() on the inputs that made the old element by element
+-- search quadratic: a needle of //m// - 1 ##'a'## characters and a ##'b'##,
+-- searched for in //n// ##'a'## characters, which matches all but the last
+-- character of the needle at every position. Each size is also timed with a
+-- needle that is found at the end of random text.
+--
+-- ==== Usage
+-- {{{
+--     eui matchbench [size ...]
+-- }}}
+--
+-- Sizes are the length of the text, and default to 10_000 and 1_000_000.
+-- Needles are 4, 32, 33 and 1_000 characters long. Needles of up to 32 small
+-- integers are searched for with Boyer-Moore-Horspool, which still takes up to
+-- //n * m// steps on this input, longer ones with Two-Way, which takes at most
+-- about //2n//. Each search is repeated until it has taken at least a quarter
+-- of a second, and the time of one search is shown in microseconds.
+--
+
+include std/convert.e
+include std/rand.e
+
+constant
+	MIN_TIME = 0.25,
+	NEEDLES = { 4, 32, 33, 1_000 }
+
+-- microseconds per match(x, s)
+function time_match(sequence x, sequence s)
+	integer n = 0, reps = 1
+	atom t, elapsed
+
+	while 1 do
+		t = time()
+		for i = 1 to reps do
+			n += match(x, s)
+		end for
+		elapsed = time() - t
+		if elapsed >= MIN_TIME then
+			exit
+		end if
+		reps *= 2
+	end while
+	return elapsed / reps * 1e6
+end function
+
+sequence args = command_line(), sizes = {}
+for i = 3 to length(args) do
+	sizes &= to_integer(args[i], 1000)
+end for
+if length(sizes) = 0 then
+	sizes = { 10_000, 1_000_000 }
+end if
+
+set_rand(1)
+puts(1, "      size needle   worst case  random text\n")
+for i = 1 to length(sizes) do
+	integer n = sizes[i]
+	sequence worst = repeat('a', n)
+	sequence text = rand(repeat(26, n)) + 'a' - 1
+	for j = 1 to length(NEEDLES) do
+		integer m = NEEDLES[j]
+		if m > n then
+			exit
+		end if
+		printf(1, "%10d %6d %12.2f %12.2f\n", {
+			n, m,
+			time_match(repeat('a', m - 1) & 'b', worst),
+			time_match(text[n - m + 1 .. n], text) })
+	end for
+end for
@@ -0,0 +1,50 @@
+--****
+-- === bench/parkern.ex
+--
+-- The loops timed by [[:parloop.ex]]. Each element of the result is a
+-- polynomial of the elements of two other sequences, computed in a
+-- ##with parallel## loop.
+--
+-- ==== Usage
+-- {{{
+--     parkern [elements [rounds]]
+-- }}}
+--
+-- Prints the number of seconds the loops took, and a checksum of the
+-- results.
+--
+
+include std/convert.e
+
+sequence args = command_line()
+integer n = 1_000_000, rounds = 20
+if length(args) >= 3 then
+	n = to_integer(args[3], n)
+end if
+if length(args) >= 4 then
+	rounds = to_integer(args[4], rounds)
+end if
+
+sequence x = repeat(0, n), y = repeat(0, n), r = repeat(0, n)
+for i = 1 to n do
+	x[i] = i / n
+	y[i] = 1 - i / n
+end for
+
+atom t = time()
+for k = 1 to rounds do
+	with parallel
+	for i = 1 to n do
+		r[i] = sqrt(((((((x[i] * 0.5 + y[i]) * x[i] - 0.25) * y[i] + 1.5) * x[i]
+			- y[i] / 3) * x[i] + 2) * y[i] - x[i] / 7) * x[i] + y[i] * y[i] + 4)
+			/ (i + k)
+	end for
+	without parallel
+end for
+t = time() - t
+
+atom sum = 0
+for i = 1 to n by 997 do
+	sum += r[i]
+end for
+printf(1, "%.3f %.10g\n", { t, sum })
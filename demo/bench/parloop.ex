@@ -0,0 +1,97 @@
+--****
+-- === bench/parloop.ex
+--
+-- Times the ##with parallel## loops in [[:parkern.ex]] translated to
+-- OpenMP loops, with different numbers of threads.
+--
+-- ==== Usage
+-- {{{
+--     eui parloop [threads ...]
+-- }}}
+--
+-- With no arguments it tries 1 thread, then doubles up to one per processor,
+-- so on a 16 core machine it shows how the loops scale up to 16 threads.
+-- Run it from ##demo/bench## in a source checkout; ##euc## must be on the
+-- path and the C compiler must support OpenMP. The translated program is
+-- built in a scratch directory that is removed afterwards.
+--
+
+include std/convert.e
+include std/filesys.e
+include std/io.e
+include std/os.e
+include std/search.e
+include std/sequence.e
+
+constant
+	SOURCE = canonical_path("parkern.ex"),
+	BUILD_DIR = canonical_path("parloop-build") & SLASH,
+	PROGRAM = BUILD_DIR & "parkern"
+
+function cores()
+	ifdef WINDOWS then
+		return to_integer(getenv("NUMBER_OF_PROCESSORS"), 1)
+	elsedef
+		sequence lines = read_lines("/proc/cpuinfo")
+		integer n = 0
+		for i = 1 to length(lines) do
+			if begins("processor", lines[i]) then
+				n += 1
+			end if
+		end for
+		if n = 0 then
+			n = 1
+		end if
+		return n
+	end ifdef
+end function
+
+sequence args = command_line(), threads = {}
+for i = 3 to length(args) do
+	threads &= to_integer(args[i], 1)
+end for
+if length(threads) = 0 then
+	integer n = 1
+	while n < cores() do
+		threads &= n
+		n *= 2
+	end while
+	threads &= cores()
+end if
+
+if not file_exists(SOURCE) then
+	puts(2, "Can't find " & SOURCE & ", run this from demo/bench\n")
+	abort(1)
+end if
+
+create_directory(BUILD_DIR)
+if system_exec(sprintf(`euc -silent -build-dir "%s" -o "%s" "%s"`,
+	{ BUILD_DIR, PROGRAM, SOURCE }), 2) != 0
+then
+	remove_directory(BUILD_DIR, 1)
+	puts(2, "euc failed\n")
+	abort(1)
+end if
+
+printf(1, "Running %s\n\n", { SOURCE })
+puts(1, "threads    seconds  speedup\n")
+atom base = 0
+for i = 1 to length(threads) do
+	setenv("OMP_NUM_THREADS", sprintf("%d", threads[i]))
+	sequence out = BUILD_DIR & "out.txt"
+	delete_file(out)
+	system(sprintf(`"%s" > "%s"`, { PROGRAM, out }), 2)
+	object fields = read_file(out)
+	if atom(fields) then
+		puts(2, "Can't run " & PROGRAM & "\n")
+		exit
+	end if
+	fields = split(fields, ' ')
+	atom t = to_number(fields[1])
+	if base = 0 then
+		base = t
+	end if
+	printf(1, "%7d %10.3f %8.2f\n", { threads[i], t, base / t })
+end for
+
+remove_directory(BUILD_DIR, 1)
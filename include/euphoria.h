@@ -198,6 +198,13 @@ struct ns_list {
 	int file_num;
 };
 
+struct name_hash {
+	int size;
+	int *disp;
+	int *first;
+	int *next;
+};
+
 typedef struct d  *d_ptr;
 typedef struct s1 *s1_ptr;
 
@@ -286,6 +293,7 @@ void *which_file(object, int);
 object unary_op(int, object);
 object NewS1(intptr_t);
 object compare(object, object);
+object equal(object, object);
 intptr_t get_pos_int(char *, intptr_t);
 object memory_set(object d, object v, object n);
 object memory_copy(object d, object s, object n);
@@ -332,6 +340,7 @@ char *malloc(size_t);
 void setran();
 void eu_startup(struct routine_list *rl, struct ns_list *nl, char **ip,
 				int cps, int clk);
+void eu_name_hash(struct name_hash *rh, struct name_hash *nh);
 void exit(int);
 int CRoutineId(int, int, object);
 object e_sqrt(object);
@@ -345,6 +354,7 @@ void RTFatal(char *);
 
 // be_alloc:
 char *TransAlloc(unsigned long);
+void EFree(char *);
 
 // be_decompress:
 object decompress(uintptr_t c);
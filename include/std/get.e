@@ -9,7 +9,6 @@ namespace stdget
 
 include std/error.e
 include std/io.e
-include std/scinot.e
 
 --****
 -- === Error Status Constants
@@ -21,490 +20,28 @@ public constant
 	GET_FAIL = 1,
 	GET_NOTHING = -2
 
-constant DIGITS = "0123456789",
-		 HEX_DIGITS = DIGITS & "ABCDEF",
-		 START_NUMERIC = DIGITS & "-+.#"
-
-constant TRUE = 1
-
-type natural(integer x)
-	return x >= 0
-end type
-
-type char(integer x)
-	return x >= -1 and x <= 255
-end type
-
-natural input_file  -- file to be read from
-
-object input_string -- string to be read from
-natural string_next
-
-char ch  -- the current character
-
-procedure get_ch()
--- set ch to the next character in the input stream (either string or file)
-	if sequence(input_string) then
-		if string_next <= length(input_string) then
-			ch = input_string[string_next]
-			string_next += 1
-		else
-			ch = GET_EOF
-		end if
-	else
-		ch = getc(input_file)
-		if ch = GET_EOF then
-			string_next += 1
-		end if
-	end if
-end procedure
-
-constant white_space = " \t\n\r"
-procedure skip_blanks()
--- skip white space
--- ch is "live" at entry and exit
-
-	while find(ch, white_space) do
-		get_ch()
-	end while
-end procedure
-
-constant ESCAPE_CHARS = "n'\"t\\r",
-		 ESCAPED_CHARS = "\n'\"\t\\\r"
-
-function escape_char(char c)
--- return escape character
-	natural i
-
-	i = find(c, ESCAPE_CHARS)
-	if i = 0 then
-		return GET_FAIL
-	else
-		return ESCAPED_CHARS[i]
-	end if
-end function
-
-function get_qchar()
--- get a single-quoted character
--- ch is "live" at exit
-	char c
-
-	get_ch()
-	c = ch
-	if ch = '\\' then
-		get_ch()
-		c = escape_char(ch)
-		if c = GET_FAIL then
-			return {GET_FAIL, 0}
-		end if
-	elsif ch = '\'' then
-		return {GET_FAIL, 0}
-	end if
-	get_ch()
-	if ch != '\'' then
-		return {GET_FAIL, 0}
-	else
-		get_ch()
-		return {GET_SUCCESS, c}
-	end if
-end function
-
-function get_heredoc( sequence terminator )
-	sequence text = ""
-	integer ends_at = 1 - length( terminator )
-	while ends_at < 1 or not match( terminator, text, ends_at ) with entry do
-		if ch = GET_EOF then
-			return { GET_FAIL, 0 }
-		end if
-	entry
-		get_ch()
-		text &= ch
-		ends_at += 1
-	end while
-	return { GET_SUCCESS, head( text, length( text ) - length( terminator ) ) }
-end function
-
-function get_string()
--- get a double-quoted character string
--- ch is "live" at exit
-	sequence text
-
-	text = ""
-	while TRUE do
-		get_ch()
-		if ch = GET_EOF or ch = '\n' then
-			return {GET_FAIL, 0}
-		elsif ch = '"' then
-			get_ch()
-			if length( text ) = 0 and ch = '"' then
-				if ch = '"' then
-					return get_heredoc( `"""` )
-				end if
-			end if
-			return {GET_SUCCESS, text}
-		elsif ch = '\\' then
-			get_ch()
-			ch = escape_char(ch)
-			if ch = GET_FAIL then
-				return {GET_FAIL, 0}
-			end if
-		end if
-		text = text & ch
-	end while
-end function
-
-
-type plus_or_minus(integer x)
-	return x = -1 or x = +1
-end type
-
-constant GET_IGNORE = GET_NOTHING
-function read_comment()
-	if atom(input_string) then
-		while ch!='\n' and ch!='\r' and ch!=-1 do
-			get_ch()
-		end while
-		get_ch()
-		if ch=-1 then
-			return {GET_EOF, 0}
-		else
-			return {GET_IGNORE, 0}
-		end if
-	else
-		for i=string_next to length(input_string) do
-			ch=input_string[i]
-			if ch='\n' or ch='\r' then
-				string_next=i+1
-				return {GET_IGNORE, 0}
-			end if
-		end for
-		return {GET_EOF, 0}
-	end if
-end function
-
-function get_number()
--- read a number or a comment
--- ch is "live" at entry and exit
-	plus_or_minus sign, e_sign
-	natural ndigits
-	integer hex_digit
-	atom mantissa, dec, e_mag
-	sequence number_string = { ch }
-
-	sign = +1
-	mantissa = 0
-	ndigits = 0
-
-	-- process sign
-	if ch = '-' then
-		sign = -1
-		get_ch()
-		number_string &= ch
-		if ch='-' then
-			return read_comment()
-		end if
-	elsif ch = '+' then
-		get_ch()
-		number_string &= ch
-	end if
-
-	-- get mantissa
-	if ch = '#' then
-		-- process hex integer and return
-		get_ch()
-		number_string &= ch
-		while TRUE do
-			hex_digit = find(ch, HEX_DIGITS)-1
-			if hex_digit >= 0 then
-				ndigits += 1
-				mantissa = mantissa * 16 + hex_digit
-				get_ch()
-				number_string &= ch
-			else
-				if ndigits > 0 then
-					return {GET_SUCCESS, sign * mantissa}
-				else
-					return {GET_FAIL, 0}
-				end if
-			end if
-		end while
-	end if
-
-	-- decimal integer or floating point
-	while ch >= '0' and ch <= '9' do
-		ndigits += 1
-		mantissa = mantissa * 10 + (ch - '0')
-		get_ch()
-		number_string &= ch
-	end while
-
-	if ch = '.' then
-		-- get fraction
-		get_ch()
-		number_string &= ch
-		dec = 10
-		while ch >= '0' and ch <= '9' do
-			ndigits += 1
-			mantissa += (ch - '0') / dec
-			dec *= 10
-			get_ch()
-			number_string &= ch
-		end while
-	end if
-
-	if ndigits = 0 then
-		return {GET_FAIL, 0}
-	end if
-
-	mantissa = sign * mantissa
-
-	if ch = 'e' or ch = 'E' then
-		
-		-- get exponent sign
-		get_ch()
-		number_string &= ch
-		if ch = '-' then
-			get_ch()
-			number_string &= ch
-		elsif ch = '+' then
-			get_ch()
-			number_string &= ch
-		end if
-		
-		-- get exponent magnitude
-		if ch >= '0' and ch <= '9' then
-			
-			while ch >= '0' and ch <= '9' with entry do
-				number_string &= ch
-			entry
-				get_ch()
-			end while
-		else
-			return {GET_FAIL, 0} -- no exponent
-		end if
-		
-		mantissa = scientific_to_atom( number_string )
-	end if
-
-	return {GET_SUCCESS, mantissa}
-end function
-
-function Get()
--- read a Euphoria data object as a string of characters
--- and return {error_flag, value}
--- Note: ch is "live" at entry and exit of this routine
-	sequence s, e
-	integer e1
-
-	-- init
-	while find(ch, white_space) do
-		get_ch()
-	end while
-
-	if ch = -1 then -- string is made of whitespace only
-		return {GET_EOF, 0}
-	end if
-
-	while 1 do
-		if find(ch, START_NUMERIC) then
-			e = get_number()
-			if e[1] != GET_IGNORE then -- either a number or something illegal was read, so exit: the other goto
-				return e
-			end if          -- else go read next item, starting at top of loop
-			skip_blanks()
-			if ch=-1 or ch='}' then -- '}' is expected only in the "{--\n}" case
-				return {GET_NOTHING, 0} -- just a comment
-			end if
-		elsif ch = '{' then
-			-- process a sequence
-			s = {}
-			get_ch()
-			skip_blanks()
-			if ch = '}' then -- empty sequence
-				get_ch()
-				return {GET_SUCCESS, s} -- empty sequence
-			end if
-
-			while TRUE do -- read: comment(s), element, comment(s), comma and so on till it terminates or errors out
-				while 1 do -- read zero or more comments and an element
-					e = Get() -- read next element, using standard function
-					e1 = e[1]
-					if e1 = GET_SUCCESS then
-						s = append(s, e[2])
-						exit  -- element read and added to result
-					elsif e1 != GET_IGNORE then
-						return e
-					-- else it was a comment, keep going
-					elsif ch='}' then
-						get_ch()
-						return {GET_SUCCESS, s} -- empty sequence
-					end if
-				end while
-
-				while 1 do -- now read zero or more post element comments
-					skip_blanks()
-					if ch = '}' then
-						get_ch()
-					return {GET_SUCCESS, s}
-					elsif ch!='-' then
-						exit
-					else -- comment starts after item and before comma
-						e = get_number() -- reads anything starting with '-'
-						if e[1] != GET_IGNORE then  -- it wasn't a comment, this is illegal
-							return {GET_FAIL, 0}
-						end if
-						-- read next comment or , or }
-					end if
-			end while
-				if ch != ',' then
-				return {GET_FAIL, 0}
-				end if
-			get_ch() -- skip comma
-			end while
-
-		elsif ch = '\"' then
-			return get_string()
-		elsif ch = '`' then
-			return get_heredoc("`")
-		elsif ch = '\'' then
-			return get_qchar()
-		else
-			return {GET_FAIL, 0}
-
-		end if
-
-	end while
-
-end function
-
-integer leading_whitespace
-
-function Get2()
--- read a Euphoria data object as a string of characters
--- and return {error_flag, value, total number of characters, leading whitespace}
--- Note: ch is "live" at entry and exit of this routine.
--- Uses the regular Get() to read sequence elements.
-	sequence s, e
-	integer e1
-    natural offset
-
-	-- init
-	offset = string_next-1
-	get_ch()
-	while find(ch, white_space) do
-		get_ch()
-	end while
-
-	if ch = -1 then -- string is made of whitespace only
-		return {GET_EOF, 0, string_next-1-offset ,string_next-1}
-	end if
-
-	leading_whitespace = string_next-2-offset -- index of the last whitespace: string_next points past the first non whitespace
-
-	while 1 do
-		if find(ch, START_NUMERIC) then
-			e = get_number()
-			if e[1] != GET_IGNORE then -- either a number or something illegal was read, so exit: the other goto
-				return e & {string_next-1-offset-(ch!=-1), leading_whitespace}
-			end if          -- else go read next item, starting at top of loop
-			get_ch()
-			if ch=-1 then
-				return {GET_NOTHING, 0, string_next-1-offset-(ch!=-1), leading_whitespace} -- empty sequence
-			end if
-
-		elsif ch = '{' then
-			-- process a sequence
-			s = {}
-			get_ch()
-			skip_blanks()
-			if ch = '}' then -- empty sequence
-				get_ch()
-				return {GET_SUCCESS, s, string_next-1-offset-(ch!=-1), leading_whitespace} -- empty sequence
-			end if
-
-			while TRUE do -- read: comment(s), element, comment(s), comma and so on till it terminates or errors out
-				while 1 do -- read zero or more comments and an element
-					e = Get() -- read next element, using standard function
-					e1 = e[1]
-					if e1 = GET_SUCCESS then
-						s = append(s, e[2])
-						exit  -- element read and added to result
-					elsif e1 != GET_IGNORE then
-						return e & {string_next-1-offset-(ch!=-1), leading_whitespace}
-					-- else it was a comment, keep going
-					elsif ch='}' then
-						get_ch()
-						return {GET_SUCCESS, s, string_next-1-offset-(ch!=-1),leading_whitespace} -- empty sequence
-					end if
-				end while
-
-				while 1 do -- now read zero or more post element comments
-					skip_blanks()
-					if ch = '}' then
-						get_ch()
-					return {GET_SUCCESS, s, string_next-1-offset-(ch!=-1), leading_whitespace}
-					elsif ch!='-' then
-						exit
-					else -- comment starts after item and before comma
-						e = get_number() -- reads anything starting with '-'
-						if e[1] != GET_IGNORE then  -- it was not a comment, this is illegal
-							return {GET_FAIL, 0, string_next-1-offset-(ch!=-1),leading_whitespace}
-						end if
-						-- read next comment or , or }
-					end if
-			end while
-				if ch != ',' then
-				return {GET_FAIL, 0, string_next-1-offset-(ch!=-1), leading_whitespace}
-				end if
-			get_ch() -- skip comma
-			end while
-
-		elsif ch = '\"' then
-			e = get_string()
-			return e & {string_next-1-offset-(ch!=-1), leading_whitespace}
-		elsif ch = '`' then
-			e = get_heredoc("`")
-			return e & {string_next-1-offset-(ch!=-1), leading_whitespace}
-		elsif ch = '\'' then
-			e = get_qchar()
-			return e & {string_next-1-offset-(ch!=-1), leading_whitespace}
-		else
-			return {GET_FAIL, 0, string_next-1-offset-(ch!=-1), leading_whitespace}
-
-		end if
-
-	end while
-
-end function
+constant M_GET_VALUE = 116
 
 --****
 -- === Answer Types
 
 public constant
-	GET_SHORT_ANSWER = routine_id("Get"),
-	GET_LONG_ANSWER  = routine_id("Get2")
+	GET_SHORT_ANSWER = 0,
+	GET_LONG_ANSWER  = 1
 
 function get_value(object target, integer start_point, integer answer_type)
 	if answer_type != GET_SHORT_ANSWER and answer_type != GET_LONG_ANSWER then
 		error:crash("Invalid type of answer, please only use %s (the default) or %s.", {"GET_SHORT_ANSWER", "GET_LONG_ANSWER"})
 	end if
 	if atom(target) then -- get()
-		input_file = target
 		if start_point then
 			if io:seek(target, io:where(target)+start_point) then
 				error:crash("Initial seek() for get() failed!")
 			end if
 		end if
-		string_next = 1
-		input_string = 0
-	else
-		input_string = target
-		string_next = start_point
-	end if
-	if answer_type = GET_SHORT_ANSWER then
-		get_ch()
+		start_point = 1
 	end if
-	return call_func(answer_type, {})
+	return machine_func(M_GET_VALUE, {target, start_point, answer_type = GET_LONG_ANSWER})
 end function
 
 --****
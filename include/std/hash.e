@@ -10,13 +10,20 @@ namespace stdhash
 --
 
 public enum
-	HSIEH30 = -6,
+	WYHASH_SEEDED = -8,
+	WYHASH,
+	HSIEH30,
 	HSIEH32,
 	ADLER32,
 	FLETCHER32,
 	MD5,
 	SHA256
 
+constant
+	M_HASH_INIT = 117,
+	M_HASH_UPDATE = 118,
+	M_HASH_FINAL = 119
+
 --****
 -- === Routines
 --
@@ -31,6 +38,10 @@ public enum
 -- Parameters:
 --		# ##source## : Any Euphoria object
 --		# ##algo## : A code indicating which algorithm to use.
+-- ** ##WYHASH## uses wyhash. Returns a Euphoria integer. Very fast and excellent dispersion
+-- ** ##WYHASH_SEEDED## uses wyhash with a seed chosen at random when the program
+--            starts. Returns a Euphoria integer. Use it for hash tables that hold
+--            keys from untrusted sources, such as [[:map]]s do.
 -- ** ##HSIEH30## uses Hsieh. Returns a 30-bit (a Euphoria integer). Fast and good dispersion
 -- ** ##HSIEH32## uses Hsieh. Returns a 32-bit value. Fast and very good dispersion
 -- ** ##ADLER32## uses Adler. Very fast and reasonable dispersion, especially for small strings
@@ -56,6 +67,14 @@ public enum
 --
 -- Comments:
 -- * For ##algo## values from zero to less than one, that actual value used is ##(algo + 69096)##. 
+-- * ##WYHASH## and ##WYHASH_SEEDED## return the top 62 bits of a 64-bit hash on 64-bit
+--   platforms, and the top 30 bits on 32-bit platforms. A sequence of bytes gives the
+--   same value as [[:hash_final]] after the same bytes were given to [[:hash_update]].
+-- * Someone who can choose the keys of a hash table can make many of them have the same
+--   hash value, and every lookup then has to compare all of them. The seed of
+--   ##WYHASH_SEEDED## is different each time a program runs, so the values can't be
+--   predicted. Set the environment variable ##EUHASHSEED## to a number to use that seed
+--   instead, to repeat a run exactly.
 --
 -- Example 1:
 -- <eucode>
@@ -71,3 +90,73 @@ public enum
 -- ? hash(1.23,                                          99        ) --> 3808916725
 -- ? hash({1, {2,3, {4,5,6}, 7}, 8.9},                   99        ) -->  526266621
 -- </eucode>
+
+--**
+-- starts hashing data that is given a piece at a time.
+--
+-- Parameters:
+-- # ##algo## : ##WYHASH## (the default) or ##WYHASH_SEEDED##.
+-- # ##seed## : an atom, the seed of ##WYHASH##, from 0 to less than power(2, 64).
+--   Defaults to 0, which is the seed [[:hash]] uses.
+--
+-- Returns:
+-- A **sequence**, the state of the hash. Pass it to [[:hash_update]] and [[:hash_final]].
+--
+-- Comments:
+-- The state is an ordinary sequence, so it can be copied to hash several
+-- strings that start with the same bytes.
+--
+-- Example 1:
+-- <eucode>
+-- integer fn = open("big.dat", "rb")
+-- sequence h = hash_init()
+-- while 1 do
+--     sequence chunk = get_bytes(fn, 65536)
+--     if length(chunk) = 0 then
+--         exit
+--     end if
+--     h = hash_update(h, chunk)
+-- end while
+-- close(fn)
+-- ? hash_final(h) -- the same as hash(read_file("big.dat"), WYHASH)
+-- </eucode>
+--
+-- See Also:
+--   [[:hash_update]], [[:hash_final]], [[:hash]]
+
+public function hash_init(integer algo = WYHASH, atom seed = 0)
+	return machine_func(M_HASH_INIT, {algo, seed})
+end function
+
+--**
+-- adds bytes to a hash started by [[:hash_init]].
+--
+-- Parameters:
+-- # ##state## : the state from [[:hash_init]] or an earlier ##hash_update##.
+-- # ##bytes## : a sequence of bytes.
+--
+-- Returns:
+-- A **sequence**, the new state of the hash.
+--
+-- See Also:
+--   [[:hash_init]], [[:hash_final]]
+
+public function hash_update(sequence state, sequence bytes)
+	return machine_func(M_HASH_UPDATE, {state, bytes})
+end function
+
+--**
+-- returns the hash value of all the bytes given to [[:hash_update]].
+--
+-- Parameters:
+-- # ##state## : the state from [[:hash_init]] or [[:hash_update]].
+--
+-- Returns:
+-- An **integer**, the hash value, as [[:hash]] returns it for the same bytes.
+--
+-- See Also:
+--   [[:hash_init]], [[:hash_update]]
+
+public function hash_final(sequence state)
+	return machine_func(M_HASH_FINAL, state)
+end function
@@ -15,7 +15,8 @@ constant M_SEEK  = 19,
 		 M_WHERE = 20,
 		 M_FLUSH = 60,
 		 M_LOCK_FILE = 61,
-		 M_UNLOCK_FILE = 62
+		 M_UNLOCK_FILE = 62,
+		 M_INTERN = 111
 
 --****
 -- === Constants
@@ -97,6 +98,11 @@ public constant EOF = (-1)
 -- Comments:
 -- This is not used to write to "binary" files as it only outputs text.
 --
+-- Atoms that are not integers are shown with the fewest significant digits that read
+-- back as the same atom, so ##print(STDOUT, 1/3)## shows all the digits of the result.
+-- Atoms that need no more than ten digits look the same as with the ##"%.10g"## format
+-- of [[:printf]].
+--
 -- Example 1:
 -- <eucode>
 -- include std/io.e
@@ -1095,6 +1101,8 @@ end procedure
 -- Parameters:
 --		##file## : an object, either a file path or the handle to an open file.
 --                 If this is an empty string, STDIN (the console) is used.
+--		##intern_lines## : an integer (default is 0). If not zero, each line is
+--                 passed through [[:intern]], so repeated lines share memory.
 --
 -- Returns:
 --		-1 on error or a **sequence**, made of lines from the file, as [[:gets]] could read them.
@@ -1102,6 +1110,9 @@ end procedure
 -- Comments:
 --	If ##file## was a sequence, the file will be closed on completion. Otherwise, it will remain open, but at end of file.
 --
+-- Use ##intern_lines## for files with many repeated lines, such as logs or
+-- lists of keywords.
+--
 -- Example 1:
 -- <eucode>
 -- data = read_lines("my_file.txt")
@@ -1122,7 +1133,7 @@ end procedure
 -- See Also:
 --		[[:gets]], [[:write_lines]], [[:read_file]]
 
-public function read_lines(object file)
+public function read_lines(object file, integer intern_lines = 0)
 	object fn, ret, y
 	if sequence(file) then
 		if length(file) = 0 then
@@ -1147,6 +1158,9 @@ public function read_lines(object file)
 				end if
 			end ifdef
 		end if
+		if intern_lines then
+			y = machine_func(M_INTERN, {y, 0})
+		end if
 		ret = append(ret, y)
 		if fn = 0 then
 			puts(2, '\n')
@@ -97,14 +97,16 @@ constant
 	REMOVED_SLOT = { REMOVED, 0, 0 },
 	$
 
-ifdef BITS32 then
-	constant DEFAULT_HASH = HSIEH30
-elsedef
-	constant DEFAULT_HASH = HSIEH30
-end ifdef
+-- seeded, so keys can't be chosen to collide
+constant DEFAULT_HASH = WYHASH_SEEDED
 
 function hash( object x )
-	return eu:hash( x, DEFAULT_HASH )
+	ifdef BITS64 then
+		-- lookup() adds hash values to 32-bit slot indexes in an integer
+		return and_bits( eu:hash( x, DEFAULT_HASH ), #3FFF_FFFF )
+	elsedef
+		return eu:hash( x, DEFAULT_HASH )
+	end ifdef
 end function
 
 --****
@@ -877,7 +879,8 @@ end function
 --   A **sequence** made of all the keys in the map.
 --
 -- Comments:
---   If ##sorted_result## is not used, the order of the keys returned is not predicable. 
+--   If ##sorted_result## is not used, the order of the keys returned is not predicable,
+--   and changes from one run of the program to the next.
 --
 -- Example 1:
 --   <eucode>
@@ -1017,7 +1020,8 @@ end function
 --   sub-sequence in the form ##{key, value}##
 --
 -- Comments:
---   If ##sorted_result## is not used, the order of the values returned is not predicable. 
+--   If ##sorted_result## is not used, the order of the values returned is not predicable,
+--   and changes from one run of the program to the next.
 --
 -- Example 1:
 -- <eucode>
@@ -471,6 +471,119 @@ end function
 -- [[:system]], [[:abort]]
 --
 
+--****
+-- === Memory Statistics
+--
+
+constant
+	M_HEAP_STATS   = 108,
+	M_ALLOC_SAMPLE = 109,
+	M_ALLOC_SITES  = 110
+
+public enum
+	HEAP_LIVE_BYTES,
+	HEAP_PEAK_BYTES,
+	HEAP_LIVE_BLOCKS,
+	HEAP_CLASS_SIZES,
+	HEAP_CLASS_BLOCKS,
+	HEAP_LARGE_BLOCKS,
+	HEAP_LARGE_BYTES,
+	HEAP_DOUBLES_IN_USE,
+	HEAP_DOUBLES_POOLED,
+	HEAP_CACHED_BLOCKS,
+	HEAP_PEAK_RSS
+
+--****
+-- These constants index the sequence returned by [[:heap_stats]].
+--
+-- * ##HEAP_LIVE_BYTES## ~-- bytes in blocks the program is using
+-- * ##HEAP_PEAK_BYTES## ~-- the highest ##HEAP_LIVE_BYTES## so far
+-- * ##HEAP_LIVE_BLOCKS## ~-- number of blocks the program is using
+-- * ##HEAP_CLASS_SIZES## ~-- the block sizes of the allocator's size classes
+-- * ##HEAP_CLASS_BLOCKS## ~-- blocks in use in each of those size classes
+-- * ##HEAP_LARGE_BLOCKS## ~-- blocks in use that are bigger than any size class
+-- * ##HEAP_LARGE_BYTES## ~-- bytes in those large blocks
+-- * ##HEAP_DOUBLES_IN_USE## ~-- floating point atoms that are alive
+-- * ##HEAP_DOUBLES_POOLED## ~-- free slots left in the pool of floating point atoms
+-- * ##HEAP_CACHED_BLOCKS## ~-- freed blocks kept by the allocator for reuse
+-- * ##HEAP_PEAK_RSS## ~-- the peak resident memory of the process in bytes,
+--   as reported by the operating system, or 0 if it is not available
+
+--**
+-- returns statistics about the memory used by Euphoria objects.
+--
+-- Returns:
+--   A **sequence**, indexed by the ##HEAP_## constants.
+--
+-- Comments:
+-- The counters are always kept, so this can be called from long running programs
+-- to export metrics. Blocks in a size class are counted with the size of their class.
+-- The pool of floating point atoms is itself allocated in large blocks.
+--
+-- On //OpenBSD// and //NetBSD// the C library can't report the size of a block,
+-- so blocks it allocates are counted in ##HEAP_LIVE_BLOCKS## only, not in the
+-- byte counts or the size classes.
+--
+-- Example 1:
+-- <eucode>
+-- sequence stats = heap_stats()
+-- printf(1, "%d bytes in %d blocks\n", stats[HEAP_LIVE_BYTES..HEAP_LIVE_BLOCKS])
+-- </eucode>
+--
+-- See Also:
+--   [[:sample_allocations]]
+
+public function heap_stats()
+	return machine_func(M_HEAP_STATS, 0)
+end function
+
+--**
+-- starts or stops charging allocations to the source lines that make them.
+--
+-- Parameters:
+-- # ##every## : an integer, sample one allocation out of ##every##, or 0 to stop sampling.
+--
+-- Returns:
+--   An **integer**, the previous sampling rate.
+--
+-- Comments:
+-- Sampling only works in the interpreter. Translated programs do not know which line
+-- is executing, and [[:allocation_sites]] stays empty.
+--
+-- See Also:
+--   [[:allocation_sites]], [[:heap_stats]]
+
+public function sample_allocations(integer every)
+	return machine_func(M_ALLOC_SAMPLE, every)
+end function
+
+--**
+-- returns where the sampled allocations were made.
+--
+-- Parameters:
+-- # ##clear## : an integer, non-zero to forget the samples collected so far. Defaults to 0.
+--
+-- Returns:
+--   A **sequence**, with one ##{routine, file, line, samples, bytes}## entry for each source
+--   line that was sampled. ##samples## is the number of sampled allocations made on that
+--   line and ##bytes## the number of bytes they requested. Multiply both by the sampling rate
+--   to estimate the totals.
+--
+-- Example 1:
+-- <eucode>
+-- sample_allocations(1000)
+-- handle_requests()
+-- sequence sites = allocation_sites(1)
+-- sites = sort_columns(sites, {-5})  -- biggest first
+-- </eucode>
+--
+-- See Also:
+--   [[:sample_allocations]]
+
+public function allocation_sites(integer clear = 0)
+	return machine_func(M_ALLOC_SITES, clear)
+end function
+
 --****
 -- === Miscellaneous
 
@@ -22,7 +22,8 @@ include std/win32/w32dllconst.ew
 
 	constant
 		kernel32 = dll:open_dll("kernel32.dll"),
-		--iGetExitCodeProcess=define_c_func(kernel32,"GetExitCodeProcess",{C_UINT,C_POINTER},C_INT),
+		iGetExitCodeProcess=dll:define_c_func(kernel32,"GetExitCodeProcess",{dll:C_POINTER, dll:C_POINTER}, dll:C_BOOL),
+		iWaitForSingleObject=dll:define_c_func(kernel32,"WaitForSingleObject",{dll:C_POINTER, dll:C_DWORD}, dll:C_DWORD),
 		iCreatePipe = dll:define_c_func(kernel32,"CreatePipe",{dll:C_POINTER, dll:C_POINTER, dll:C_POINTER, dll:C_DWORD},dll:C_BOOL),
 		iReadFile = dll:define_c_func(kernel32,"ReadFile",{dll:C_POINTER, dll:C_POINTER, dll:C_DWORD, dll:C_POINTER, dll:C_POINTER}, dll:C_BOOL),
 		iWriteFile = dll:define_c_func(kernel32,"WriteFile",{dll:C_POINTER, dll:C_POINTER, dll:C_DWORD, dll:C_POINTER, dll:C_POINTER}, dll:C_BOOL),
@@ -39,6 +40,9 @@ include std/win32/w32dllconst.ew
 		HANDLE_FLAG_INHERIT=1,
 		STARTF_USESHOWWINDOW = 1,
 		STARTF_USESTDHANDLES = 256,
+		INFINITE = #FFFFFFFF,
+		WAIT_OBJECT_0 = 0,
+		WAIT_TIMEOUT = #102,
 		FAIL = 0,
 		$
 ifdef BITS32 then
@@ -70,12 +74,15 @@ elsedef
 		FORK   = dll:define_c_func(STDLIB, "fork",   {}, dll:C_INT),
 		EXECV  = dll:define_c_func(STDLIB, "execv",  {dll:C_POINTER, dll:C_POINTER}, dll:C_INT),
 		SIGNAL = dll:define_c_func(STDLIB, "signal", {dll:C_INT, dll:C_POINTER}, dll:C_POINTER),
+		WAITPID = dll:define_c_func(STDLIB, "waitpid", {dll:C_INT, dll:C_POINTER, dll:C_INT}, dll:C_INT),
 		ERRNO  = dll:define_c_var( STDLIB, "errno"),
 		FAIL   = -1
 	
 	enum
 		os_stdin = 0, os_stdout, os_stderr,
 		os_sig_dfl = 0, os_sig_ign
+	
+	constant WNOHANG = 1
 end ifdef
 
 --****
@@ -157,6 +164,83 @@ public function close(atom fd)
 	return 0
 end function
 
+--**
+-- waits for process ##p## to finish.
+--
+-- Parameters:
+--   # ##p## : the process, as returned by [[:exec]]
+--   # ##block## : an integer (default is 1). If zero, return at once when the
+--                 process is still running.
+--
+-- Returns:
+--   An **atom**, the exit status of the process, or -1 if ##block## is zero
+--   and the process has not finished yet, or -2 if the process could not be
+--   waited on. [[:error_no]] then gives the reason. On //Unix// a process ended
+--   by a signal has a status of 128 plus the signal number, as in the shell.
+--
+-- Comments:
+--   The pipes of ##p## are not closed. Once the exit status has been
+--   returned, the process is gone and must not be waited on again. On //Unix//
+--   doing so returns -2.
+--
+-- Example 1:
+-- <eucode>
+-- object p = exec("make", create())
+-- pipeio:close(p[STDIN])
+-- -- ... read p[STDOUT] until it is empty ...
+-- atom status = wait(p)
+-- </eucode>
+--
+
+public function wait(process p, integer block = 1)
+	atom status
+	
+	ifdef WINDOWS then
+		atom timeout = 0, pcode
+		if block then
+			timeout = INFINITE
+		end if
+		status = c_func(iWaitForSingleObject, {p[PID], timeout})
+		if status = WAIT_TIMEOUT then
+			return -1
+		elsif status != WAIT_OBJECT_0 then
+			os_errno = get_errno()
+			return -2
+		end if
+		pcode = machine:allocate(4)
+		if c_func(iGetExitCodeProcess, {p[PID], pcode}) = FAIL then
+			os_errno = get_errno()
+			status = -2
+		else
+			status = peek4u(pcode)
+		end if
+		machine:free(pcode)
+		c_func(iCloseHandle, {p[PID]})
+	elsedef
+		atom pstatus = machine:allocate(4)
+		integer options = WNOHANG, ret
+		if block then
+			options = 0
+		end if
+		ret = c_func(WAITPID, {p[PID], pstatus, options})
+		status = peek4s(pstatus)
+		machine:free(pstatus)
+		if ret = 0 then
+			return -1
+		elsif ret = FAIL then
+			os_errno = get_errno()
+			return -2
+		end if
+		if and_bits(status, #7F) = 0 then
+			status = and_bits(floor(status / 256), #FF)
+		else
+			status = 128 + and_bits(status, #7F)
+		end if
+	end ifdef
+	
+	return status
+end function
+
 --**
 -- closes pipes and kills process ##p## with signal signal (default 15).
 --
@@ -6,6 +6,8 @@
 
 namespace pretty
 
+constant M_SPRINT = 115
+
 -- pretty print variables
 integer pretty_end_col, pretty_chars, pretty_start_col, pretty_level, 
 		pretty_file, pretty_ascii, pretty_indent, pretty_ascii_min,
@@ -109,7 +111,9 @@ procedure rPrint(object a)
 					end if
 				end if
 			end if
-		else    
+		elsif length(pretty_fp_format) = 0 then
+			sbuff = machine_func(M_SPRINT, a)
+		else
 			sbuff = sprintf(pretty_fp_format, a)
 		end if
 		pretty_out(sbuff)
@@ -173,9 +177,9 @@ procedure rPrint(object a)
 end procedure
 
 ifdef UNIX then
-	public constant PRETTY_DEFAULT = {1, 2, 1, 78, "%d", "%.10g", 32, 126, 1000000000, 1}
+	public constant PRETTY_DEFAULT = {1, 2, 1, 78, "%d", "", 32, 126, 1000000000, 1}
 elsedef
-	public constant PRETTY_DEFAULT = {1, 2, 1, 78, "%d", "%.10g", 32, 127, 1000000000, 1}
+	public constant PRETTY_DEFAULT = {1, 2, 1, 78, "%d", "", 32, 127, 1000000000, 1}
 end ifdef
 
 public enum
@@ -242,7 +246,8 @@ end procedure
 --   # column we are starting at ~-- default: 1
 --   # approximate column to wrap at ~-- default: 78
 --   # format to use for integers ~-- default: "%d"
---   # format to use for floating-point numbers ~-- default: "%.10g"
+--   # format to use for floating-point numbers ~-- default: "", the fewest digits
+--     that read back as the same atom, as [[:print]] shows them
 --   # minimum value for printable ASCII ~-- default 32
 --   # maximum value for printable ASCII ~-- default 127
 --   # maximum number of lines to output 
@@ -10,6 +10,13 @@ include std/types.e
 include std/search.e
 include std/sort.e
 
+constant
+	M_INTERN = 111,
+	M_INTERN_PURGE = 112,
+	M_SPLIT = 120,
+	M_SPLIT_ANY = 121,
+	M_JOIN = 122
+
 --****
 -- === Constants
 
@@ -613,6 +620,66 @@ public function shuffle(object seq)
 	return seq
 end function
 
+--**
+-- returns a shared copy of a string, so that equal strings occupy memory only once.
+--
+-- Parameters:
+--		# ##x##: the object to intern.
+--		# ##deep##: an integer (default is 0). If not zero, the strings nested
+--                 anywhere inside ##x## are interned as well.
+--
+-- Returns:
+--		An **object**, equal to ##x##.
+--
+-- Comments:
+-- A string here is any sequence whose elements are all integers. The first
+-- time a string is interned it is remembered in a table; interning an equal
+-- string afterwards returns the remembered copy. Programs that hold many
+-- repeated values, such as field names or category labels, use less memory
+-- this way, and [[:equal]] and [[:compare]] return at once when both
+-- arguments are the same copy.
+--
+-- Atoms, sequences that are not strings (unless ##deep## is set) and
+-- objects that have a delete routine are returned unchanged.
+--
+-- The table keeps every interned string alive. Call [[:intern_purge]] to
+-- release the ones the program no longer uses.
+--
+-- Example 1:
+-- <eucode>
+-- sequence a = intern("category")
+-- sequence b = intern("cate" & "gory")
+-- -- a and b now share the same memory
+-- </eucode>
+--
+-- Example 2:
+-- <eucode>
+-- rows = intern(rows, 1) -- share every repeated string in rows
+-- </eucode>
+--
+-- See Also:
+--		[[:intern_purge]], [[:split]], [[:read_lines]], [[:deserialize]]
+
+public function intern(object x, integer deep = 0)
+	return machine_func(M_INTERN, {x, deep})
+end function
+
+--**
+-- releases interned strings that are no longer used.
+--
+-- Returns:
+--		An **integer**, the number of strings released from the intern table.
+--
+-- Comments:
+-- Only strings that nothing but the intern table refers to are released.
+--
+-- See Also:
+--		[[:intern]]
+
+public function intern_purge()
+	return machine_func(M_INTERN_PURGE, 0)
+end function
+
 --****
 -- === Building Sequences
 --
@@ -2050,6 +2117,9 @@ end function
 --                   trailing and duplicated delimiters are not significant.
 --   # ##limit## : an integer (default is 0). The maximum number of sub-sequences
 --                to create. If zero, there is no limit.
+--   # ##intern_parts## : an integer (default is 0). If not zero, the sub-sequences
+--                       that are strings are passed through [[:intern]], so
+--                       repeated values share memory.
 --
 -- Returns:
 --		A **sequence**, of sub-sequences of ##source##. Delimiters are removed.
@@ -2084,84 +2154,14 @@ end function
 -- See Also:
 --     [[:split_any]], [[:breakup]], [[:join]]
 
-public function split( sequence st, object delim=' ', integer no_empty = 0, integer limit=0)
-	sequence ret = {}
-	integer start
-	integer pos
-
-	if length(st) = 0 then
-		return ret
-	end if
-
-
-	if sequence(delim) then
-		-- Handle the simple case of split("123", ""), opposite is join({"1","2","3"}, "") -- "123"
-		if equal(delim, "") then
-			for i = 1 to length(st) do
-				st[i] = {st[i]}
-				limit -= 1
-				if limit = 0 then
-					st = append(st[1 .. i],st[i+1 .. $])
-					exit
-				end if
-			end for
-
-			return st
-		end if
-
-		start = 1
-		while start <= length(st) do
-			pos = match(delim, st, start)
-
-			if pos = 0 then
-				exit
-			end if
-
-			ret = append(ret, st[start..pos-1])
-			start = pos+length(delim)
-			limit -= 1
-			if limit = 0 then
-				exit
-			end if
-		end while
-	else
-		start = 1
-		while start <= length(st) do
-			pos = find(delim, st, start)
-
-			if pos = 0 then
-				exit
-			end if
-
-			ret = append(ret, st[start..pos-1])
-			start = pos + 1
-			limit -= 1
-			if limit = 0 then
-				exit
-			end if
-		end while
-	end if
-
-	ret = append(ret, st[start..$])
+public function split( sequence st, object delim=' ', integer no_empty = 0, integer limit=0,
+		integer intern_parts = 0)
+	sequence ret = machine_func(M_SPLIT, {st, delim, no_empty, limit})
 
-	integer k = length(ret)
-	if no_empty then
-		k = 0
-		for i = 1 to length(ret) do
-			if length(ret[i]) != 0 then
-				k += 1
-				if k != i then
-					ret[k] = ret[i]
-				end if
-			end if
-		end for
-	end if
-
-	if k < length(ret) then
-		return ret[1 .. k]
-	else
-		return ret
+	if intern_parts then
+		ret = machine_func(M_INTERN, {ret, 1})
 	end if
+	return ret
 end function
 
 --**
@@ -2204,48 +2204,11 @@ end function
 --   [[:split]], [[:breakup]], [[:join]]
 
 public function split_any(sequence source, object delim=", \t|", integer limit=0, integer no_empty=0)
-	sequence ret = {}
-	integer start = 1, pos, next_pos
-
 	if length(delim) = 0 then
 		return {source}
 	end if
 
-	while 1 do
-		pos = search:find_any(delim, source, start)
-		next_pos = pos + 1
-		if pos then
-			ret = append(ret, source[start..pos-1])
-			start = next_pos
-			limit -= 1
-			if limit = 0 then
-				exit
-			end if
-		else
-			exit
-		end if
-	end while
-
-	ret = append(ret, source[start..$])
-
-	integer k = length(ret)
-	if no_empty then
-		k = 0
-		for i = 1 to length(ret) do
-			if length(ret[i]) != 0 then
-				k += 1
-				if k != i then
-					ret[k] = ret[i]
-				end if
-			end if
-		end for
-	end if
-
-	if k < length(ret) then
-		return ret[1 .. k]
-	else
-		return ret
-	end if
+	return machine_func(M_SPLIT_ANY, {source, delim, limit, no_empty})
 end function
 
 --**
@@ -2274,18 +2237,7 @@ end function
 --     [[:split]], [[:split_any]], [[:breakup]]
 
 public function join(sequence items, object delim=" ")
-	object ret
-
-	if not length(items) then return {} end if
-
-	ret = {}
-	for i=1 to length(items)-1 do
-		ret &= items[i] & delim
-	end for
-
-	ret &= items[$]
-
-	return ret
+	return machine_func(M_JOIN, {items, delim})
 end function
 
 -- Style options for breakup()
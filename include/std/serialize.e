@@ -10,6 +10,8 @@ include std/dll.e
 include std/error.e
 include std/machine.e
 
+constant M_INTERN = 111
+
 -- Serialized format of Euphoria objects
 --
 -- First byte:
@@ -249,6 +251,8 @@ end function
 -- file is assumed to be at a serialized object in the file.
 -- # ##pos## : optional index into ##sdata##. If omitted 1 is assumed. The index must
 -- point to the start of a serialized object.
+-- # ##intern_strings## : optional integer. If not zero, every string in the
+-- result is passed through [[:intern]], so repeated values share memory.
 --
 -- Returns:
 -- The return **value**, depends on the input type. 
@@ -339,18 +343,27 @@ end function
 -- </eucode>
 --
 
-public function deserialize(object sdata, integer pos = 1)
+public function deserialize(object sdata, integer pos = 1, integer intern_strings = 0)
 -- read a serialized Euphoria object
+	object res
 	
 	if integer(sdata) then
-		return deserialize_file(sdata, 0)
+		res = deserialize_file(sdata, 0)
+		if intern_strings then
+			res = machine_func(M_INTERN, {res, 1})
+		end if
+		return res
 	end if
 	
 	if atom(sdata) then
 		return 0
 	end if
 	
-	return deserialize_object(sdata, pos, 0)
+	res = deserialize_object(sdata, pos, 0)
+	if intern_strings then
+		res[1] = machine_func(M_INTERN, {res[1], 1})
+	end if
+	return res
 	
 end function
 
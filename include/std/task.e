@@ -22,6 +22,9 @@
 namespace task
 
 constant M_SLEEP = 64
+constant M_FREE_BUDGET = 107
+constant M_ARENA_BEGIN = 113
+constant M_ARENA_END = 114
 
 --**
 -- suspends a task for a short period, allowing other tasks to run in the meantime.
@@ -47,6 +50,96 @@ public procedure task_delay(atom delaytime)
 	end while
 end procedure
 
+--**
+-- limits how much garbage is released at once when a sequence is freed.
+--
+-- Parameters:
+--		# ##budget## : an integer, the number of elements released each time
+--        a sequence dies, or 0 to release everything immediately.
+--
+-- Returns:
+--		An **integer**, the previous budget.
+--
+-- Comments:
+--
+-- By default, dropping the last reference to a large structure frees all of it
+-- before the program continues, which can stall the task that happened to release it.
+-- With a non-zero budget only about ##budget## elements are released at that
+-- point. The rest is queued and released a slice at a time by [[:task_yield]], 
+-- and in full while the scheduler is waiting for a real-time task.
+--
+-- Setting the budget back to 0 releases everything still queued.
+--
+-- Example 1:
+-- <eucode>
+-- -- keep request latency flat in a task based server
+-- set_free_budget(10_000)
+-- </eucode>
+--
+-- See Also:
+-- [[:task_yield]]
+
+public function set_free_budget(integer budget)
+	return machine_func(M_FREE_BUDGET, budget)
+end function
+
+--**
+-- starts an arena scope for short-lived data.
+--
+-- Returns:
+--		An **integer**, the nesting depth of arena scopes, counting this one.
+--
+-- Comments:
+--
+-- Until the matching [[:arena_end]], small sequences and strings are carved out of
+-- large regions instead of being allocated one at a time. Freeing them only
+-- updates a count, and a region is reused or given back as a whole once
+-- everything in it is dead. This suits a request handler that builds many
+-- temporary values which are all garbage when it returns.
+--
+-- Values that are still referenced when the scope ends remain valid. They
+-- keep their region alive until they are freed in the usual way, so a handler
+-- that keeps a little of each request will hold on to more memory than it
+-- otherwise would.
+--
+-- Scopes may be nested; the inner ones share the region of the outermost.
+-- Memory from [[:allocate]] never comes from an arena, and neither do the
+-- tables the runtime keeps for itself. An interned string or a [[:printf]]
+-- format made inside a scope is copied or left out of the cache rather than
+-- keeping its region alive.
+--
+-- Example 1:
+-- <eucode>
+-- procedure handle_request(sequence request)
+--     arena_begin()
+--     sequence reply = build_reply(parse(request))
+--     send(reply)
+--     arena_end()
+-- end procedure
+-- </eucode>
+--
+-- See Also:
+-- [[:arena_end]], [[:set_free_budget]]
+
+public function arena_begin()
+	return machine_func(M_ARENA_BEGIN, 0)
+end function
+
+--**
+-- ends the innermost arena scope.
+--
+-- Returns:
+--		An **integer**, the number of values allocated in arenas that are still alive.
+--		A non-zero result after the outermost scope ends means some values
+--		escaped and are keeping their region in memory.
+--
+-- See Also:
+-- [[:arena_begin]]
+
+public function arena_end()
+	return machine_func(M_ARENA_END, 0)
+end function
+
 --****
 -- Signature:
 -- <built-in> procedure task_clock_start()
@@ -17,6 +17,11 @@ include std/search.e
 include std/sequence.e
 include std/serialize.e
 
+constant
+	M_SPRINT = 115,
+	M_TRIM = 123,
+	M_CHANGE_CASE = 124
+
 --****
 -- === Routines
 
@@ -69,8 +74,9 @@ include std/serialize.e
 -- This is exactly the same as ##print(fn, x)##, except that the output is returned as a sequence of characters, rather
 -- than being sent to a file or device. ##x## can be any Euphoria object.
 --
--- The atoms contained within ##x## will be displayed to a maximum of ten significant digits,
--- just as with [[:print]].
+-- The atoms contained within ##x## will be displayed with the fewest significant digits
+-- that read back as the same atoms, just as with [[:print]]. Atoms that need no more than
+-- ten digits look the same as with the ##"%.10g"## format of [[:sprintf]].
 --
 -- Example 1:
 -- <eucode>
@@ -88,27 +94,7 @@ include std/serialize.e
 --    [[:sprintf]], [[:printf]]
 
 public function sprint(object x)
-	sequence s
-
-	if atom(x) then
-		return sprintf("%.10g", x)
-	else
-		s = "{"
-		for i = 1 to length(x) do
-			if atom(x[i]) then
-				s &= sprintf("%.10g", x[i])
-			else
-				s &= sprint(x[i])
-			end if
-			s &= ','
-		end for
-		if s[$] = ',' then
-			s[$] = '}'
-		else
-			s &= '}'
-		end if
-		return s
-	end if
+	return machine_func(M_SPRINT, x)
 end function
 
 --**
@@ -139,24 +125,11 @@ end function
 --   [[:trim_tail]], [[:trim]], [[:pad_head]]
 
 public function trim_head(sequence source, object what=" \t\r\n", integer ret_index = 0)
-	integer lpos
 	if atom(what) then
 		what = {what}
 	end if
 
-	lpos = 1
-	while lpos <= length(source) do
-		if not find(source[lpos], what) then
-			exit
-		end if
-		lpos += 1
-	end while
-
-	if ret_index then
-		return lpos
-	else
-		return source[lpos .. $]
-	end if
+	return machine_func(M_TRIM, {source, what, 1, ret_index})
 end function
 
 --**
@@ -186,25 +159,11 @@ end function
 --   [[:trim_head]], [[:trim]], [[:pad_tail]]
 
 public function trim_tail(sequence source, object what=" \t\r\n", integer ret_index = 0)
-	integer rpos
-
 	if atom(what) then
 		what = {what}
 	end if
 
-	rpos = length(source)
-	while rpos > 0 do
-		if not find(source[rpos], what) then
-			exit
-		end if
-		rpos -= 1
-	end while
-
-	if ret_index then
-		return rpos
-	else
-		return source[1..rpos]
-	end if
+	return machine_func(M_TRIM, {source, what, 2, ret_index})
 end function
 
 --**
@@ -237,51 +196,17 @@ end function
 --   [[:trim_head]], [[:trim_tail]]
 
 public function trim(sequence source, object what=" \t\r\n", integer ret_index = 0)
-	integer rpos
-	integer lpos
-
 	if atom(what) then
 		what = {what}
 	end if
 
-	lpos = 1
-	while lpos <= length(source) do
-		if not find(source[lpos], what) then
-			exit
-		end if
-		lpos += 1
-	end while
-
-	rpos = length(source)
-	while rpos > lpos do
-		if not find(source[rpos], what) then
-			exit
-		end if
-		rpos -= 1
-	end while
-
-	if ret_index then
-		return {lpos, rpos}
-	else
-		if lpos = 1 then
-			if rpos = length(source) then
-				return source
-			end if
-		end if
-		if lpos > length(source) then
-			return {}
-		end if
-		return source[lpos..rpos]
-	end if
+	return machine_func(M_TRIM, {source, what, 3, ret_index})
 end function
 
-ifdef UNIX then
-	constant TO_LOWER = 'a' - 'A'
-end ifdef
-
 sequence lower_case_SET = {}
 sequence upper_case_SET = {}
 sequence encoding_NAME = "ASCII"
+integer encoding_UTF8 = 0 -- sequences of bytes are decoded as UTF-8
 
 function load_code_page(sequence cpname)
 	object cpdata
@@ -389,17 +314,27 @@ end function
 -- Comments:
 -- * ##lc## and ##uc## must be the same length.
 -- * If no parameters are given, the default ASCII table is set.
+-- * If ##en## is ##"UTF-8"##, the sets are Unicode code points, and [[:lower]] and
+--   [[:upper]] read a sequence of bytes as UTF-8 text. Bytes that are not valid
+--   UTF-8 are left as they are. With any other name each element is changed on
+--   its own, as [[:mapping]] does.
 --
 -- Example 1:
 -- <eucode>
 -- set_encoding_properties( "Elvish", "aeiouy", "AEIOUY")
 -- </eucode>
 --
--- Example 1:
+-- Example 2:
 -- <eucode>
 -- set_encoding_properties( "1251") -- Loads a predefined code page.
 -- </eucode>
 --
+-- Example 3:
+-- <eucode>
+-- set_encoding_properties( "UTF-8", {#E4, #F6}, {#C4, #D6})
+-- s = upper("\xC3\xB6") -- "\xC3\x96", the UTF-8 for "Ö"
+-- </eucode>
+--
 -- See Also:
 --   [[:lower]], [[:upper]], [[:get_encoding_properties]]
 
@@ -411,6 +346,7 @@ public procedure set_encoding_properties(sequence en = "", sequence lc = "", seq
 		if res != 0 then
 			printf(2, "Failed to load code page '%s'. Error # %d\n", {en, res})
 		end if
+		encoding_UTF8 = find(encoding_NAME, {"UTF-8", "utf-8", "UTF8", "utf8"}) != 0
 		return
 	end if
 
@@ -421,6 +357,7 @@ public procedure set_encoding_properties(sequence en = "", sequence lc = "", seq
 		lower_case_SET = lc
 		upper_case_SET = uc
 		encoding_NAME = en
+		encoding_UTF8 = find(en, {"UTF-8", "utf-8", "UTF8", "utf8"}) != 0
 	end if
 end procedure
 
@@ -512,6 +449,9 @@ end ifdef
 --   the ##'a'..'z'## range. If you need to do case conversion with other encodings
 --   use the [[:set_encoding_properties]] first.
 -- * ##x## may be a sequence of any shape, all atoms of which will be acted upon.
+-- * With a ##"UTF-8"## encoding from [[:set_encoding_properties]], a sequence
+--   of bytes is read as UTF-8 text, so the result is UTF-8 as well.
+-- * If nothing needs to change, ##x## itself is returned.
 --
 -- **WARNING**, When using ASCII encoding, this can also affect floating point
 -- numbers in the range ##65## to ##90##.
@@ -533,13 +473,13 @@ end ifdef
 
 public function lower(object x)
 	if length(lower_case_SET) != 0 then
-		return stdseq:mapping(x, upper_case_SET, lower_case_SET)
+		return machine_func(M_CHANGE_CASE, {x, 0, upper_case_SET, lower_case_SET, encoding_UTF8})
 	end if
 	
 	ifdef WINDOWS then
 		return change_case(x, api_CharLowerBuff)
 	elsedef	
-		return x + (x >= 'A' and x <= 'Z') * TO_LOWER
+		return machine_func(M_CHANGE_CASE, {x, 0, "", "", 0})
 	end ifdef
 end function
 
@@ -558,6 +498,9 @@ end function
 --   the ##'a'..'z'## range. If you need to do case conversion with other encodings
 --   use the [[:set_encoding_properties]] first.
 -- * ##x## may be a sequence of any shape, all atoms of which will be acted upon.
+-- * With a ##"UTF-8"## encoding from [[:set_encoding_properties]], a sequence
+--   of bytes is read as UTF-8 text, so the result is UTF-8 as well.
+-- * If nothing needs to change, ##x## itself is returned.
 --
 -- **WARNING**, When using ASCII encoding, this can also affects floating point
 -- numbers in the range ##97## to ##122##.
@@ -579,12 +522,12 @@ end function
 
 public function upper(object x)
 	if length(upper_case_SET) != 0 then
-		return stdseq:mapping(x, lower_case_SET, upper_case_SET)
+		return machine_func(M_CHANGE_CASE, {x, 1, lower_case_SET, upper_case_SET, encoding_UTF8})
 	end if
 	ifdef WINDOWS then
 		return change_case(x, api_CharUpperBuff)
 	elsedef	
-		return x - (x >= 'a' and x <= 'z') * TO_LOWER
+		return machine_func(M_CHANGE_CASE, {x, 1, "", "", 0})
 	end ifdef
 
 end function
@@ -223,6 +223,15 @@ ifdef ENO_DBL_CACHE
   MEM_FLAGS+=-DNO_DBL_CACHE
 endif
 
+ifdef ELTO
+  ifdef ERUNTIME
+    # keep the GCC intermediate code in the runtime library so that
+    # euc -lto can optimize it together with the translated program
+    LTO_FLAGS=-flto -ffat-lto-objects
+    AR=$(CC_PREFIX)gcc-ar
+  endif
+endif
+
 ifdef COVERAGE
     COVERAGEFLAG=-fprofile-arcs -ftest-coverage
     DEBUG_FLAGS=-g3 -O0 -Wall
@@ -314,7 +323,7 @@ ifeq "$(MANAGED_MEM)" "1"
 else
     FE_FLAGS =  $(ARCH_FLAG) $(COVERAGEFLAG) $(MSIZE) $(EPTHREAD) -Wno-unused-variable -Wno-unused-but-set-variable -c -fsigned-char $(EOSTYPE) $(EOSMING) -ffast-math $(FP_FLAGS) $(EOSFLAGS) $(DEBUG_FLAGS) -I$(CYPTRUNKDIR)/source -I$(CYPTRUNKDIR) $(PROFILE_FLAGS) -DARCH=$(ARCH) $(EREL_TYPE) $(OPT)
 endif
-BE_FLAGS =  $(ARCH_FLAG) $(COVERAGEFLAG) $(MSIZE) $(OPT) $(EPTHREAD) -c -Wall $(EOSTYPE) $(EBSDFLAG) $(RUNTIME_FLAGS) $(EOSFLAGS) $(BACKEND_FLAGS) -fsigned-char -ffast-math $(FP_FLAGS) $(DEBUG_FLAGS) $(MEM_FLAGS) $(PROFILE_FLAGS) -DARCH=$(ARCH) $(EREL_TYPE) $(FPIC) -I$(TRUNKDIR)/source
+BE_FLAGS =  $(ARCH_FLAG) $(COVERAGEFLAG) $(MSIZE) $(OPT) $(EPTHREAD) -c -Wall $(EOSTYPE) $(EBSDFLAG) $(RUNTIME_FLAGS) $(EOSFLAGS) $(BACKEND_FLAGS) -fsigned-char -ffast-math $(FP_FLAGS) $(DEBUG_FLAGS) $(MEM_FLAGS) $(PROFILE_FLAGS) $(LTO_FLAGS) -DARCH=$(ARCH) $(EREL_TYPE) $(FPIC) -I$(TRUNKDIR)/source
 
 # Disable Position Independent Executable (PIE)
 ifneq (,$(shell $(CC) -v 2>&1 | grep default-pie))
@@ -361,6 +370,7 @@ EU_INTERPRETER_FILES = \
 	$(TRUNKDIR)/source/eui.ex
 
 EU_TRANSLATOR_FILES = \
+	$(TRUNKDIR)/source/buildjobs.e \
 	$(TRUNKDIR)/source/buildsys.e \
 	$(TRUNKDIR)/source/c_decl.e \
 	$(TRUNKDIR)/source/c_out.e \
@@ -368,6 +378,7 @@ EU_TRANSLATOR_FILES = \
 	$(TRUNKDIR)/source/compile.e \
 	$(TRUNKDIR)/source/compress.e \
 	$(TRUNKDIR)/source/global.e \
+	$(TRUNKDIR)/source/objcache.e \
 	$(TRUNKDIR)/source/traninit.e \
 	$(TRUNKDIR)/source/euc.ex
 
@@ -147,12 +147,14 @@ EU_INTERPRETER_FILES = &
 	eui.ex 
 
 EU_TRANSLATOR_FILES = &
+	buildjobs.e &
 	buildsys.e &
 	c_decl.e &
 	c_out.e &
 	cominit.e &
 	compile.e &
 	compress.e &
+	objcache.e &
 	traninit.e &
 	euc.ex
 	
@@ -36,12 +36,18 @@
 #include <inttypes.h>
 #ifdef _WIN32
 #include <windows.h>
+#include <malloc.h>
 #else
 #include <unistd.h>
+#include <sys/resource.h>
 #endif
 #include "alldefs.h"
 #include "be_runtime.h"
 #include "be_alloc.h"
+#ifndef ERUNTIME
+#include "be_execute.h"
+#include "be_symtab.h"
+#endif
 
 /******************/
 /* Local defines  */
@@ -93,6 +99,7 @@ unsigned long max_bytes_allocated = 0;   /* high water mark */
 #endif
 
 d_ptr d_list = NULL;
+intptr_t doubles_in_use = 0;
 //static int dblcnt = 0;
 static struct block_list *pool_map[MAX_CACHED_SIZE/RESOLUTION+1]; /* maps size desired
 														  to appropriate list */
@@ -104,6 +111,22 @@ static struct block_list *pool_map[MAX_CACHED_SIZE/RESOLUTION+1]; /* maps size d
 static struct block_list freeblk_list[NUMBER_OF_FBL]; /* set of free block lists */
 						 /* elements not power of 2 - but not used much */
 
+/* Heap statistics, always kept. A block is counted in the size class of the
+   free block list it would be returned to, and bytes are counted as that
+   list's size, so the numbers don't drift as blocks move between lists.
+   Blocks too big to cache are counted in an extra class with their usable
+   size. */
+static uintptr_t live_bytes = 0;
+static uintptr_t peak_bytes = 0;
+static intptr_t live_blocks = 0;
+static intptr_t class_blocks[NUMBER_OF_FBL+1];
+static uintptr_t large_bytes = 0;
+
+/* allocation site sampling: every alloc_sample_rate'th allocation is
+   charged to the line being executed (interpreter only) */
+static intptr_t alloc_sample_rate = 0;
+static intptr_t alloc_sample_countdown = 0;
+
 /**********************/
 /* Declared functions */
 /**********************/
@@ -396,6 +419,48 @@ static void Free_All()
 // }
 // #endif
 
+static void count_block(long nbytes, int delta)
+/* record that a block with nbytes usable bytes was allocated (delta 1)
+   or freed (delta -1) */
+{
+	struct block_list *list;
+	int class;
+
+	if (nbytes > MAX_CACHED_SIZE) {
+		class = NUMBER_OF_FBL;
+	}
+	else {
+		list = pool_map[((nbytes + RESOLUTION - 1) >> LOG_RESOLUTION)];
+		if (list->size > nbytes && list > freeblk_list)
+			list--;  /* same adjustment as EFree() */
+		class = list - freeblk_list;
+		nbytes = list->size;
+	}
+	if (class == NUMBER_OF_FBL)
+		large_bytes += delta * nbytes;
+	class_blocks[class] += delta;
+	live_blocks += delta;
+	live_bytes += delta * nbytes;
+	if (live_bytes > peak_bytes)
+		peak_bytes = live_bytes;
+}
+
+#ifdef ESIMPLE_MALLOC
+static void count_malloc(char *p, int delta)
+/* count a block that came straight from malloc() */
+{
+#ifdef BLOCK_SIZE_UNKNOWN
+	live_blocks += delta;  /* its size can't be asked for */
+#else
+	count_block(block_size(p), delta);
+#endif
+}
+#endif
+
+#ifndef ERUNTIME
+static void sample_allocation(uintptr_t nbytes);
+#endif
+
 void SpaceMessage()
 {
 	/* should we free up something first, to ensure iprintf's work? */
@@ -420,6 +485,238 @@ static char *Out_Of_Space(long nbytes)
 	}
 }
 #endif
+
+/* Arena scopes: between arena_begin() and arena_end() small sequences are
+   bump-allocated from 64K chunks instead of going through malloc and the
+   free lists. Only NewS1() allocates from an arena; the runtime's own
+   tables and buffers always come from EMalloc() and the heap, so that
+   something created lazily inside a scope can't pin a chunk for the rest
+   of the run. Freeing a block only decrements its chunk's count of live
+   blocks. A chunk goes back to the system when its last block is freed
+   and it is no longer the chunk being allocated from, so blocks that
+   outlive the scope stay valid and simply keep their chunk alive.
+   Chunks are aligned on their size, which lets EFree() find the chunk of
+   any block from its address. */
+#define ARENA_CHUNK_SIZE 65536
+#define ARENA_MAX_BLOCK 1024     /* larger requests use the heap */
+#define ARENA_SPARE_CHUNKS 8     /* empty chunks kept for the next scope */
+
+struct arena_chunk {
+	char *top;          /* next free byte */
+	intptr_t live;      /* blocks handed out and not freed yet */
+	int closed;         /* no longer allocated from */
+};
+#define ARENA_FIRST_BLOCK(c) ((char *)(c) + ((sizeof(struct arena_chunk) + 7) & ~7))
+
+int arena_depth = 0;                         /* nesting of arena_begin() */
+static struct arena_chunk *arena_current = NULL;
+static struct arena_chunk **arena_table = NULL; /* chunks by address */
+static uintptr_t arena_table_size = 0;
+static uintptr_t arena_chunks = 0;              /* chunks in arena_table */
+static struct arena_chunk *arena_spare[ARENA_SPARE_CHUNKS];
+static int arena_spares = 0;
+
+#define ARENA_HASH(c) ((((uintptr_t)(c)) / ARENA_CHUNK_SIZE) & (arena_table_size - 1))
+
+static void arena_table_add(struct arena_chunk *c)
+{
+	struct arena_chunk **old_table;
+	uintptr_t old_size, i, slot;
+
+	if ((arena_chunks + 1) * 2 > arena_table_size) {
+		old_table = arena_table;
+		old_size = arena_table_size;
+		arena_table_size = old_size ? old_size * 2 : 16;
+		arena_table = (struct arena_chunk **)calloc(arena_table_size,
+													 sizeof(struct arena_chunk *));
+		if (arena_table == NULL)
+			SpaceMessage();
+		for (i = 0; i < old_size; i++) {
+			if (old_table[i] != NULL) {
+				slot = ARENA_HASH(old_table[i]);
+				while (arena_table[slot] != NULL)
+					slot = (slot + 1) & (arena_table_size - 1);
+				arena_table[slot] = old_table[i];
+			}
+		}
+		free(old_table);
+	}
+	slot = ARENA_HASH(c);
+	while (arena_table[slot] != NULL)
+		slot = (slot + 1) & (arena_table_size - 1);
+	arena_table[slot] = c;
+	arena_chunks++;
+}
+
+static struct arena_chunk *arena_find(char *p)
+/* the chunk holding block p, or NULL if p came from the heap */
+{
+	struct arena_chunk *c, *found;
+	uintptr_t slot;
+
+	c = (struct arena_chunk *)((uintptr_t)p & ~(uintptr_t)(ARENA_CHUNK_SIZE - 1));
+	slot = ARENA_HASH(c);
+	while ((found = arena_table[slot]) != NULL) {
+		if (found == c)
+			return c;
+		slot = (slot + 1) & (arena_table_size - 1);
+	}
+	return NULL;
+}
+
+static void arena_release(struct arena_chunk *c)
+/* retire an empty chunk: keep it as a spare or give it back to the system */
+{
+	uintptr_t slot, next, home;
+
+	slot = ARENA_HASH(c);
+	while (arena_table[slot] != c)
+		slot = (slot + 1) & (arena_table_size - 1);
+	arena_table[slot] = NULL;
+	/* move later members of the probe run up into the hole */
+	next = (slot + 1) & (arena_table_size - 1);
+	while (arena_table[next] != NULL) {
+		home = ARENA_HASH(arena_table[next]);
+		if (((next - home) & (arena_table_size - 1)) >=
+			((next - slot) & (arena_table_size - 1))) {
+			arena_table[slot] = arena_table[next];
+			arena_table[next] = NULL;
+			slot = next;
+		}
+		next = (next + 1) & (arena_table_size - 1);
+	}
+	arena_chunks--;
+	if (arena_spares < ARENA_SPARE_CHUNKS) {
+		arena_spare[arena_spares++] = c;
+		return;
+	}
+	count_block(ARENA_CHUNK_SIZE, -1);
+#ifdef _WIN32
+	_aligned_free(c);
+#else
+	free(c);
+#endif
+}
+
+static void arena_close_current()
+{
+	struct arena_chunk *c;
+
+	c = arena_current;
+	if (c == NULL)
+		return;
+	arena_current = NULL;
+	c->closed = TRUE;
+	if (c->live == 0)
+		arena_release(c);
+}
+
+static char *arena_alloc(uintptr_t nbytes)
+{
+	struct arena_chunk *c;
+	char *p;
+
+#ifndef ERUNTIME
+	if (alloc_sample_rate && --alloc_sample_countdown <= 0)
+		sample_allocation(nbytes);
+#endif
+	nbytes = (nbytes + 7) & ~(uintptr_t)7;
+	c = arena_current;
+	if (c == NULL || c->top + 8 + nbytes > (char *)c + ARENA_CHUNK_SIZE) {
+		arena_close_current();
+		if (arena_spares > 0) {
+			c = arena_spare[--arena_spares];
+		}
+		else {
+#ifdef _WIN32
+			c = (struct arena_chunk *)_aligned_malloc(ARENA_CHUNK_SIZE, ARENA_CHUNK_SIZE);
+#else
+			if (posix_memalign((void **)&c, ARENA_CHUNK_SIZE, ARENA_CHUNK_SIZE) != 0)
+				c = NULL;
+#endif
+			if (c == NULL)
+				SpaceMessage();
+			count_block(ARENA_CHUNK_SIZE, 1);
+		}
+		c->top = ARENA_FIRST_BLOCK(c);
+		c->live = 0;
+		c->closed = FALSE;
+		arena_table_add(c);
+		arena_current = c;
+	}
+	*(uintptr_t *)c->top = nbytes;  /* size header, for ERealloc() */
+	p = c->top + 8;
+	c->top = p + nbytes;
+	c->live++;
+	return p;
+}
+
+static void arena_free(struct arena_chunk *c)
+/* a block in chunk c was freed */
+{
+	if (--c->live == 0) {
+		if (c->closed)
+			arena_release(c);
+		else
+			c->top = ARENA_FIRST_BLOCK(c);  /* everything in it is dead */
+	}
+}
+
+static char *arena_realloc(struct arena_chunk *c, char *p, uintptr_t newsize)
+{
+	uintptr_t oldsize;
+	char *q;
+
+	oldsize = *(uintptr_t *)(p - 8);
+	if (newsize <= oldsize)
+		return p;
+	newsize = (newsize + 7) & ~(uintptr_t)7;
+	if (c == arena_current && p + oldsize == c->top &&
+		p + newsize <= (char *)c + ARENA_CHUNK_SIZE) {
+		/* last block in the chunk: grow it in place */
+		*(uintptr_t *)(p - 8) = newsize;
+		c->top = p + newsize;
+		return p;
+	}
+	if (arena_depth && newsize <= ARENA_MAX_BLOCK)
+		q = arena_alloc(newsize);
+	else
+		q = EMalloc(newsize);
+	memcpy(q, p, oldsize);
+	arena_free(c);
+	return q;
+}
+
+int in_arena(void *p)
+/* TRUE if block p was carved from an arena chunk */
+{
+	return arena_chunks && arena_find((char *)p) != NULL;
+}
+
+object arena_begin()
+/* machine_func(M_ARENA_BEGIN): returns the new nesting depth */
+{
+	return ++arena_depth;
+}
+
+object arena_end()
+/* machine_func(M_ARENA_END): leave the innermost arena scope. Returns
+   the number of arena blocks that are still alive. */
+{
+	uintptr_t i;
+	intptr_t live;
+
+	if (arena_depth > 0 && --arena_depth == 0)
+		arena_close_current();
+
+	live = 0;
+	for (i = 0; i < arena_table_size; i++) {
+		if (arena_table[i] != NULL)
+			live += arena_table[i]->live;
+	}
+	return MAKE_INT(live);
+}
+
 #ifndef ESIMPLE_MALLOC
 char *EMalloc(uintptr_t nbytes)
 /* storage allocator */
@@ -440,6 +737,10 @@ char *EMalloc(uintptr_t nbytes)
 #ifdef HEAP_CHECK
 	check_pool();
 #endif
+#ifndef ERUNTIME
+	if (alloc_sample_rate && --alloc_sample_countdown <= 0)
+		sample_allocation(nbytes);
+#endif
 #if defined(EALIGN4)
 	nbytes += align4; // allow for 4-aligned addresses that are not always 8-aligned.
 #endif
@@ -472,6 +773,7 @@ char *EMalloc(uintptr_t nbytes)
 #endif
 			list->first = temp->next;
 			cache_size--;
+			count_block(list->size, 1);
 
 #ifdef HEAP_CHECK
 			if (cache_size > 100000000)
@@ -528,6 +830,7 @@ char *EMalloc(uintptr_t nbytes)
 				// don't free. grab a new one.
 				continue;  // magic is there by chance!
 						   // (this case is remotely possible on Win95 only)
+			count_block(block_size(p), 1);
 			return p;   // already 8-aligned, should happen most of the time
 		}
 
@@ -538,6 +841,7 @@ char *EMalloc(uintptr_t nbytes)
 		if (align4) {
 			*(int *)p = MAGIC_FILLER;
 			assert((((unsigned int)p + 4) & 7) == 0);
+			count_block(block_size(p), 1);
 			return p+4;
 		}
 
@@ -547,6 +851,7 @@ char *EMalloc(uintptr_t nbytes)
 		nbytes += align4;
 #else
 		assert(((uintptr_t)p & 7) == 0);
+		count_block(block_size(p), 1);
 		return p;
 #endif
 	} while (TRUE);
@@ -558,8 +863,12 @@ void EFree(char *p)
 	char *q;
 	register long nbytes;
 	register struct block_list *list;
+	struct arena_chunk *c;
 
-
+	if (arena_chunks && (c = arena_find(p)) != NULL) {
+		arena_free(c);
+		return;
+	}
 #ifdef HEAP_CHECK
 	check_pool();
 
@@ -573,6 +882,7 @@ void EFree(char *p)
 	}
 	#endif
 	nbytes = block_size(q);
+	count_block(nbytes, -1);
 #ifdef HEAP_CHECK
 	if ((nbytes <= MAX_CACHED_SIZE) && ((nbytes & 1) != 0)) {
 		RTInternal("EFree: already free?");
@@ -731,7 +1041,10 @@ char *ERealloc(char *orig, uintptr_t newsize)
 	char *q;
 	unsigned long oldsize;
 	int res;
+	struct arena_chunk *c;
 
+	if (arena_chunks && (c = arena_find(orig)) != NULL)
+		return arena_realloc(c, orig, newsize);
 	p = orig;
 	#if defined(EALIGN4)
 	if (align4 && *(int *)(p-4) == MAGIC_FILLER)
@@ -761,16 +1074,22 @@ char *ERealloc(char *orig, uintptr_t newsize)
 		else
 			DeAllocated(oldsize - block_size(p));
 #endif
+		count_block(oldsize, -1);
+		count_block(block_size(p), 1);
 		return orig;
 	}
 	else if (((uintptr_t)q & 0x07) == ((uintptr_t)p & 0x07)) {
 		/* q is aligned the same way as p modulo 8 (almost always I think) */
+		count_block(oldsize, -1);
+		count_block(block_size(q), 1);
 		orig = orig + (q - p);
 		return orig;
 	}
 	else {
 		/* q is not aligned right (rare) - get rid of it */
 		/* I've never seen this. */
+		count_block(oldsize, -1);
+		count_block(block_size(q), 1);
 		orig = orig + (q - p);
 		p = q;
 	}
@@ -810,6 +1129,7 @@ void freeD(unsigned char *p)
 	assert(((unsigned long)p & 7) == 0);		
 	Trash(p, D_SIZE);
 	AlreadyFree((free_block_ptr)d_list, (free_block_ptr)p);
+	doubles_in_use--;
 
 	((free_block_ptr)p)->next = (free_block_ptr)d_list;
 	d_list = (d_ptr)p;
@@ -821,13 +1141,18 @@ s1_ptr NewS1(intptr_t size)
 /* size is number of elements, NOVALUE is added as an end marker */
 {
 	register s1_ptr s1;
+	uintptr_t nbytes;
 
 	assert(size >= 0);
 	if ((unsigned long)size > MAX_SEQ_LEN) {
 		// Ensure it doesn't overflow
 		SpaceMessage();
 	}
-	s1 = (s1_ptr)EMalloc(sizeof(struct s1) + (size+1) * sizeof(object));
+	nbytes = sizeof(struct s1) + (size+1) * sizeof(object);
+	if (arena_depth && nbytes <= ARENA_MAX_BLOCK)
+		s1 = (s1_ptr)arena_alloc(nbytes);
+	else
+		s1 = (s1_ptr)EMalloc(nbytes);
 	s1->ref = 1;
 	s1->base = (object_ptr)(s1 + 1);
 	s1->length = size;
@@ -839,6 +1164,19 @@ s1_ptr NewS1(intptr_t size)
 	return(s1);
 }
 
+s1_ptr NewS1Heap(intptr_t size)
+/* NewS1() for a sequence the runtime keeps, never from an arena */
+{
+	s1_ptr s1;
+	int depth;
+
+	depth = arena_depth;
+	arena_depth = 0;
+	s1 = NewS1(size);
+	arena_depth = depth;
+	return s1;
+}
+
 object NewSequence(char *data, int len)
 /* create a new sequence that may contain binary data */
 {
@@ -1028,9 +1366,14 @@ object NewDouble(eudouble d)
 {
 	register d_ptr new_dbl;
 
+#ifndef ERUNTIME
+	if (alloc_sample_rate && --alloc_sample_countdown <= 0)
+		sample_allocation(D_SIZE);
+#endif
 	if (d_list == NULL) {
 		new_dbl_block(1024);
 	}
+	doubles_in_use++;
 
 	new_dbl = d_list;
 	assert(((uintptr_t)new_dbl & 7) == 0);
@@ -1052,13 +1395,19 @@ char *ERealloc(char *orig, uintptr_t newsize)
    by accident, but newsize might be less than the current size! */
 {
 	char *q;
+	struct arena_chunk *c;
 
+	if (arena_chunks && (c = arena_find(orig)) != NULL)
+		return arena_realloc(c, orig, newsize);
+
+	count_malloc(orig, -1);
 	// make a smaller block
 	q = realloc(orig, newsize);
 
 	if (q == NULL) {
 		SpaceMessage();
 	}
+	count_malloc(q, 1);
 
 	return q;
 }
@@ -1068,9 +1417,236 @@ char *EMalloc(uintptr_t nbytes)
 /* Always returns a pointer that has 8-byte alignment (essential for our
    internal representation of an object). */
 {
-	char * p = malloc(nbytes);
+	char *p;
+
+#ifndef ERUNTIME
+	if (alloc_sample_rate && --alloc_sample_countdown <= 0)
+		sample_allocation(nbytes);
+#endif
+	p = malloc(nbytes);
 	if (p == NULL)
 		SpaceMessage();
+	count_malloc(p, 1);
 	return p;
 }
+
+void EFree(char *p)
+{
+	struct arena_chunk *c;
+
+	if (arena_chunks && (c = arena_find(p)) != NULL) {
+		arena_free(c);
+		return;
+	}
+	count_malloc(p, -1);
+	free(p);
+}
+#endif
+
+static uintptr_t peak_rss()
+/* peak resident set size of the process in bytes, 0 if unknown */
+{
+#ifdef _WIN32
+	/* PROCESS_MEMORY_COUNTERS, without needing psapi at link time */
+	struct process_memory_counters {
+		DWORD cb;
+		DWORD PageFaultCount;
+		SIZE_T PeakWorkingSetSize;
+		SIZE_T WorkingSetSize;
+		SIZE_T QuotaPeakPagedPoolUsage;
+		SIZE_T QuotaPagedPoolUsage;
+		SIZE_T QuotaPeakNonPagedPoolUsage;
+		SIZE_T QuotaNonPagedPoolUsage;
+		SIZE_T PagefileUsage;
+		SIZE_T PeakPagefileUsage;
+	} pmc;
+	typedef BOOL (WINAPI *memory_info_t)(HANDLE, struct process_memory_counters *, DWORD);
+	static memory_info_t memory_info = NULL;
+
+	if (memory_info == NULL) {
+		memory_info = (memory_info_t)GetProcAddress(GetModuleHandle("kernel32.dll"),
+													 "K32GetProcessMemoryInfo");
+		if (memory_info == NULL)
+			return 0;
+	}
+	pmc.cb = sizeof(pmc);
+	if (!memory_info(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return 0;
+	return (uintptr_t)pmc.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef EOSX
+	return (uintptr_t)usage.ru_maxrss;         /* bytes */
+#else
+	return (uintptr_t)usage.ru_maxrss * 1024;  /* kilobytes */
+#endif
+#endif
+}
+
+object heap_stats()
+/* machine_func(M_HEAP_STATS): see heap_stats() in std/os.e for the layout */
+{
+	s1_ptr result, sizes, counts;
+	uintptr_t rss;
+	int i;
+
+	rss = peak_rss();
+	sizes = NewS1(NUMBER_OF_FBL);
+	counts = NewS1(NUMBER_OF_FBL);
+	for (i = 0; i < NUMBER_OF_FBL; i++) {
+		sizes->base[i+1] = freeblk_list[i].size;
+		counts->base[i+1] = class_blocks[i];
+	}
+
+	result = NewS1(11);
+	result->base[1] = MAKE_UINT(live_bytes);
+	result->base[2] = MAKE_UINT(peak_bytes);
+	result->base[3] = live_blocks;
+	result->base[4] = MAKE_SEQ(sizes);
+	result->base[5] = MAKE_SEQ(counts);
+	result->base[6] = class_blocks[NUMBER_OF_FBL];
+	result->base[7] = MAKE_UINT(large_bytes);
+	result->base[8] = doubles_in_use;
+	result->base[9] = (intptr_t)double_blocks_allocated * 1024 - doubles_in_use;
+	result->base[10] = cache_size;
+	result->base[11] = MAKE_UINT(rss);
+	return MAKE_SEQ(result);
+}
+
+object set_alloc_sample(object x)
+/* machine_func(M_ALLOC_SAMPLE, n): charge every n'th allocation to the
+   line being executed, 0 to stop. Returns the previous rate. */
+{
+	intptr_t old_rate = alloc_sample_rate;
+
+	if (IS_ATOM_INT(x))
+		alloc_sample_rate = x;
+	else if (IS_ATOM(x))
+		alloc_sample_rate = (intptr_t)DBL_PTR(x)->dbl;
+	else
+		RTFatal("the sample rate must be an atom");
+	if (alloc_sample_rate < 0)
+		alloc_sample_rate = 0;
+	alloc_sample_countdown = alloc_sample_rate;
+	return old_rate;
+}
+
+#ifndef ERUNTIME
+struct alloc_site {
+	int gline;          /* global line number, 0 if not known */
+	symtab_ptr proc;    /* routine the line is in */
+	uintptr_t samples;  /* number of sampled allocations */
+	uintptr_t bytes;    /* bytes requested by those allocations */
+};
+
+/* open addressing on gline. The table is kept with malloc() so that
+   it doesn't show up in the statistics it is collecting. */
+static struct alloc_site *alloc_site_table = NULL;
+static int alloc_site_size = 0;
+static int alloc_site_count = 0;
+
+static struct alloc_site *find_alloc_site(int gline)
+{
+	struct alloc_site *site;
+	unsigned int mask;
+
+	mask = alloc_site_size - 1;
+	site = &alloc_site_table[((unsigned int)gline * 2654435761u) & mask];
+	while (site->samples != 0 && site->gline != gline) {
+		site = &alloc_site_table[(site - alloc_site_table + 1) & mask];
+	}
+	return site;
+}
+
+static void sample_allocation(uintptr_t nbytes)
+{
+	struct alloc_site *site, *old_table;
+	symtab_ptr proc;
+	int gline, i, old_size;
+
+	alloc_sample_countdown = alloc_sample_rate;
+
+	if (alloc_site_count * 2 >= alloc_site_size) {
+		old_table = alloc_site_table;
+		old_size = alloc_site_size;
+		alloc_site_size = old_size ? old_size * 2 : 256;
+		alloc_site_table = (struct alloc_site *)calloc(alloc_site_size,
+													   sizeof(struct alloc_site));
+		if (alloc_site_table == NULL) {
+			/* give up sampling rather than fail the allocation */
+			alloc_site_table = old_table;
+			alloc_site_size = old_size;
+			alloc_sample_rate = 0;
+			return;
+		}
+		for (i = 0; i < old_size; i++) {
+			if (old_table[i].samples != 0)
+				*find_alloc_site(old_table[i].gline) = old_table[i];
+		}
+		free(old_table);
+	}
+
+	proc = (tpc == NULL) ? NULL : Locate(tpc);
+	gline = (proc == NULL) ? 0 : FindLine(tpc, proc);
+	site = find_alloc_site(gline);
+	if (site->samples == 0) {
+		site->gline = gline;
+		site->proc = proc;
+		alloc_site_count++;
+	}
+	site->samples++;
+	site->bytes += nbytes;
+}
 #endif
+
+object alloc_sites(object x)
+/* machine_func(M_ALLOC_SITES, clear): the sampled allocation sites as
+   {routine, file, line, samples, bytes}, emptying the table if clear
+   is non-zero. Translated code has no line information and always
+   returns an empty sequence. */
+{
+	object result;
+#ifndef ERUNTIME
+	s1_ptr entry;
+	struct alloc_site *site;
+	int i;
+	intptr_t rate;
+
+	/* the allocations below would be sampled too, and could grow the
+	   table while we walk it */
+	rate = alloc_sample_rate;
+	alloc_sample_rate = 0;
+
+	result = MAKE_SEQ(NewS1(0));
+	for (i = 0; i < alloc_site_size; i++) {
+		site = &alloc_site_table[i];
+		if (site->samples == 0)
+			continue;
+		entry = NewS1(5);
+		if (site->gline == 0) {
+			entry->base[1] = NewString(site->proc ? site->proc->name : "");
+			entry->base[2] = NewString("");
+			entry->base[3] = 0;
+		}
+		else {
+			entry->base[1] = NewString(site->proc->name);
+			entry->base[2] = NewString(file_name[slist[site->gline].file_no]);
+			entry->base[3] = slist[site->gline].line;
+		}
+		entry->base[4] = MAKE_UINT(site->samples);
+		entry->base[5] = MAKE_UINT(site->bytes);
+		Append(&result, result, MAKE_SEQ(entry));
+	}
+	if (IS_ATOM_INT(x) && x != 0 && alloc_site_table != NULL) {
+		memset(alloc_site_table, 0, alloc_site_size * sizeof(struct alloc_site));
+		alloc_site_count = 0;
+	}
+	alloc_sample_rate = rate;
+#else
+	result = MAKE_SEQ(NewS1(0));
+#endif
+	return result;
+}
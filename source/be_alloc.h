@@ -133,6 +133,7 @@ typedef struct block_list * block_list_ptr;
 	stripping off the higher 3 bits and multiplying by 8.
 
 */
+extern intptr_t doubles_in_use;  /* doubles taken from d_list and not yet freed */
 #ifdef HEAP_CHECK
 	#define FreeD(p) freeD(p)
 	#define Trash(a,n) memset(a, (char)0x11, n)
@@ -140,34 +141,33 @@ typedef struct block_list * block_list_ptr;
 	extern d_ptr d_list;
 	#define FreeD(p){ ((free_block_ptr)p)->next = (free_block_ptr)d_list; \
 					  d_list = (d_ptr)p; \
+					  doubles_in_use--; \
 					}
 #endif
 
 // Size of the usable space in an allocated block
-#ifdef __unix
-	#ifdef EBSD
-		#define block_size(p) 1    // length is not stored with the block
-	#else
-		#define block_size(p) (malloc_usable_size(p))
-	#endif
-
+#if defined(EOSX)
+	#include <malloc/malloc.h>
+	#define block_size(p) (malloc_size(p))
+#elif defined(EOPENBSD) || defined(ENETBSD)
+	#define block_size(p) 1    // length is not stored with the block
+	#define BLOCK_SIZE_UNKNOWN
+#elif defined(EBSD)
+	#include <malloc_np.h>
+	#define block_size(p) (malloc_usable_size(p))
+#elif defined(__unix)
+	#include <malloc.h>
+	#define block_size(p) (malloc_usable_size(p))
+#elif defined(_WIN32)
+	#define block_size(p) HeapSize((void *)default_heap, 0, p)
 #else
-	#ifdef _WIN32
-		#define block_size(p) HeapSize((void *)default_heap, 0, p)
-	#else
-		#define block_size(p) (_msize(p))
-	#endif
+	#define block_size(p) (_msize(p))
 #endif
 
 #ifdef __unix
 #include <stdlib.h>
 #endif
-#if defined( ESIMPLE_MALLOC )
-
-	#define EFree(ptr) free(ptr)
-#else
-	extern void EFree(char *ptr);
-#endif
+extern void EFree(char *ptr);
 extern char *EMalloc(uintptr_t size);
 extern char *ERealloc(char *orig, uintptr_t newsize);
 /* Changes in the call signature of strlcpy which happened between
@@ -213,9 +213,17 @@ extern unsigned long max_bytes_allocated;   /* high water mark */
 #endif
 
 extern void InitEMalloc();
+extern object heap_stats();
+extern object set_alloc_sample(object x);
+extern object alloc_sites(object x);
+extern int arena_depth;
+extern object arena_begin();
+extern object arena_end();
+extern int in_arena(void *p);
 extern object NewSequence(char *data, int len);
 extern object NewString(char *s);
 extern s1_ptr NewS1(intptr_t size);
+extern s1_ptr NewS1Heap(intptr_t size);
 extern s1_ptr SequenceCopy(register s1_ptr a);
 extern object NewDouble(eudouble d);
 extern object NewPreallocSeq(intptr_t size, s1_ptr s1);
@@ -1683,7 +1683,7 @@ void analyze_switch()
 					c = 1;
 				}
 				else if( !IS_ATOM_INT( new_values->base[i] ) || IS_ATOM_INT( second_val ) ){
-					c = (0 == compare( new_values->base[i], second_val ) );
+					c = equal( new_values->base[i], second_val );
 				}
 				if( c ){
 					sym = values->base[i];
@@ -4683,8 +4683,7 @@ void do_exec(intptr_t *start_pc)
 				}
 				else {
 					tpc = pc;
-					top = MAKE_INT(compare(a, top));
-					top = (top == ATOM_0);
+					top = equal(a, top);
 				}
 				obj_ptr = (object_ptr)pc[3];
 				DeRefx(*obj_ptr);
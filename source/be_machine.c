@@ -3413,6 +3413,61 @@ object machine(object opcode, object x)
                     s->base[2] = 0;
                     return MAKE_SEQ(s);
                 }
+
+			case M_FREE_BUDGET:
+				return set_free_budget(x);
+
+			case M_HEAP_STATS:
+				return heap_stats();
+
+			case M_ALLOC_SAMPLE:
+				return set_alloc_sample(x);
+
+			case M_ALLOC_SITES:
+				return alloc_sites(x);
+
+			case M_INTERN:
+				return intern(x);
+
+			case M_INTERN_PURGE:
+				return intern_purge();
+
+			case M_ARENA_BEGIN:
+				return arena_begin();
+
+			case M_ARENA_END:
+				return arena_end();
+
+			case M_SPRINT:
+				return ESprint(x);
+
+			case M_GET_VALUE:
+				return EGetValue(x);
+
+			case M_HASH_INIT:
+				return hash_init(x);
+
+			case M_HASH_UPDATE:
+				return hash_update(x);
+
+			case M_HASH_FINAL:
+				return hash_final(x);
+
+			case M_SPLIT:
+				return ESplit(x);
+
+			case M_SPLIT_ANY:
+				return ESplitAny(x);
+
+			case M_JOIN:
+				return EJoin(x);
+
+			case M_TRIM:
+				return ETrim(x);
+
+			case M_CHANGE_CASE:
+				return EChangeCase(x);
+
 			/* remember to check for MAIN_SCREEN wherever appropriate ! */
 			default:
 				/* could be out-of-range int, or double, or sequence */
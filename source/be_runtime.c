@@ -22,6 +22,7 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <math.h>
+#include <float.h>
 #include <time.h>
 #include <ctype.h>
 #include <inttypes.h>
@@ -81,7 +82,7 @@
 /******************/
 #define IsDigit(x) ((x) >= '0' && (x) <= '9')
 
-#define NUM_SIZE 30     /* enough space to print a number */
+#define NUM_SIZE 48     /* enough space to print a number */
 #define LOCAL_SPACE 100 /* some local space */
 
 /* convert atom to char. *must avoid side effects in elem* */
@@ -122,6 +123,12 @@ char *TempWarningName;
 int display_warnings;
 double eustart_time;
 
+intptr_t free_budget = 0;        /* 0: free garbage immediately, otherwise the
+									max elements released per de_reference() */
+static s1_ptr deferred_frees = NULL; /* stack of dead sequences, linked through
+										their cleanup fields */
+static int draining_frees = FALSE;
+
 /**********************/
 /* Declared Functions */
 /**********************/
@@ -365,6 +372,8 @@ char *last_traced_line = NULL;
 struct routine_list *rt00;
 struct ns_list *rt01;
 char ** rt02;
+struct name_hash *rt03;  /* hash of the rt00 names, NULL if the program has none */
+struct name_hash *rt04;  /* hash of the rt01 names */
 
 /*******************/
 /* Local variables */
@@ -1079,7 +1088,7 @@ void Concat(object_ptr target, object a_obj, object b_obj)
 {
 	object_ptr p, q;
 	s1_ptr c, a, b;
-	long na, nb;
+	long na, nb, new_len;
 	object temp;
 
 	if (IS_ATOM(a_obj)) {
@@ -1127,7 +1136,38 @@ void Concat(object_ptr target, object a_obj, object b_obj)
 			}
 			return;
 		}
-		c = NewS1(na + nb);
+		if (b_obj == *target &&
+			b->ref == 1 &&
+			b->base + 1 - (object_ptr)(b+1) >= na) {
+			/* s = prefix & s: copy a into the free space in front of b */
+			q = a->base;
+			b->base -= na;
+			b->length += na;
+			p = b->base;
+			while (--na >= 0) {
+				temp = *(++q);
+				*(++p) = temp;
+				Ref(temp);
+			}
+			return;
+		}
+		if (a_obj == *target && a->ref == 1) {
+			/* growing a on the right: leave postfill for the next & */
+			new_len = EXTRA_EXPAND(na + nb);
+			c = NewS1(new_len);
+			c->length = na + nb;
+			c->postfill = new_len - c->length;
+		}
+		else if (b_obj == *target && b->ref == 1) {
+			/* growing b on the left: leave room in front for the next & */
+			new_len = EXTRA_EXPAND(na + nb);
+			c = NewS1(new_len);
+			c->length = na + nb;
+			c->base += new_len - c->length;
+		}
+		else {
+			c = NewS1(na + nb);
+		}
 		p = c->base;
 		q = a->base;
 		while (TRUE) {  // NOVALUE will be copied
@@ -1526,6 +1566,14 @@ void de_reference(s1_ptr a)
 				return;
 			}
 		}
+		if (free_budget > 0) {
+			/* deferred mode: release at most free_budget elements now,
+			   the rest is drained by task_yield() or the idle scheduler */
+			a->cleanup = (cleanup_ptr)deferred_frees;
+			deferred_frees = a;
+			drain_frees(free_budget);
+			return;
+		}
 		p = a->base;
 #ifdef EXTRA_CHECK
 		if (a->ref < 0)
@@ -1585,6 +1633,78 @@ void de_reference(s1_ptr a)
 	}
 }
 
+int drain_frees(intptr_t budget)
+/* Release elements of the deferred sequences, stopping after budget
+   elements (budget <= 0 means no limit). The sequences form a stack:
+   the one on top is emptied from the end, a dead subsequence is pushed
+   and emptied before its parent is resumed. Cleanup routines may
+   release more objects, so the top is fetched again for each element.
+   Returns TRUE if some garbage is still queued. */
+{
+	s1_ptr a, sub;
+	object t;
+	intptr_t work = 0;
+
+	if (draining_frees)
+		return deferred_frees != NULL;
+	draining_frees = TRUE;
+
+	while ((a = deferred_frees) != NULL) {
+		if (a->length == 0) {
+			deferred_frees = (s1_ptr)a->cleanup;
+			EFree((char *)a);
+			continue;
+		}
+		if (budget > 0 && ++work > budget)
+			break;
+		t = a->base[a->length--];
+		if (IS_ATOM_INT(t) || --(DBL_PTR(t)->ref) != 0)
+			continue;
+		if (IS_ATOM_DBL(t)) {
+			if (DBL_PTR(t)->cleanup != 0) {
+				cleanup_double(DBL_PTR(t));
+				// the user might have referenced this somewhere
+				if (DBL_PTR(t)->ref != 0)
+					continue;
+			}
+			FreeD((unsigned char *)DBL_PTR(t));
+		}
+		else {
+			sub = SEQ_PTR(t);
+			if (sub->cleanup != 0) {
+				cleanup_sequence(sub);
+				if (sub->ref != 0)
+					continue;
+			}
+			sub->cleanup = (cleanup_ptr)deferred_frees;
+			deferred_frees = sub;
+		}
+	}
+
+	draining_frees = FALSE;
+	return deferred_frees != NULL;
+}
+
+object set_free_budget(object x)
+/* machine_func(M_FREE_BUDGET, n): elements released per de_reference()
+   before the rest is deferred, 0 to free everything immediately.
+   Returns the previous budget. */
+{
+	intptr_t old_budget = free_budget;
+
+	if (IS_ATOM_INT(x))
+		free_budget = x;
+	else if (IS_ATOM(x))
+		free_budget = (intptr_t)DBL_PTR(x)->dbl;
+	else
+		RTFatal("the free budget must be an atom");
+	if (free_budget < 0)
+		free_budget = 0;
+	if (free_budget == 0)
+		drain_frees(0);
+	return old_budget;
+}
+
 void DeRef1(object a)
 /* Saves space. Use in top-level code (outside of loops) */
 {
@@ -2942,6 +3062,505 @@ unsigned int calc_fletcher32(object a)
 
 }
 
+// wyhash (final version 4) is by Wang Yi, released into the public domain:
+// https://github.com/wangyi-fudan/wyhash
+
+static const uint64_t wyp[4] = {
+	0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+	0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+static void wymum(uint64_t *a, uint64_t *b)
+/* the 128-bit product of a and b: low half to a, high half to b */
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 r = (unsigned __int128)*a * *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32), c = t < rl, lo, hi;
+
+	lo = t + (rm1 << 32);
+	c += lo < t;
+	hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	*a = lo;
+	*b = hi;
+#endif
+}
+
+static uint64_t wymix(uint64_t a, uint64_t b)
+{
+	wymum(&a, &b);
+	return a ^ b;
+}
+
+static uint64_t wyr8(const uint8_t *p)
+{
+	return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
+	       ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+	       ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+static uint64_t wyr4(const uint8_t *p)
+{
+	return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
+	       ((uint64_t)p[3] << 24);
+}
+
+static uint64_t wyr3(const uint8_t *p, size_t k)
+{
+	return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+static uint64_t wyhash(const uint8_t *p, size_t len, uint64_t seed)
+{
+	uint64_t a, b, see1, see2;
+	size_t i;
+
+	seed ^= wymix(seed ^ wyp[0], wyp[1]);
+	if (len <= 16) {
+		if (len >= 4) {
+			a = (wyr4(p) << 32) | wyr4(p + ((len >> 3) << 2));
+			b = (wyr4(p + len - 4) << 32) | wyr4(p + len - 4 - ((len >> 3) << 2));
+		}
+		else if (len > 0) {
+			a = wyr3(p, len);
+			b = 0;
+		}
+		else
+			a = b = 0;
+	}
+	else {
+		i = len;
+		if (i >= 48) {
+			see1 = see2 = seed;
+			do {
+				seed = wymix(wyr8(p) ^ wyp[1], wyr8(p + 8) ^ seed);
+				see1 = wymix(wyr8(p + 16) ^ wyp[2], wyr8(p + 24) ^ see1);
+				see2 = wymix(wyr8(p + 32) ^ wyp[3], wyr8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i >= 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16) {
+			seed = wymix(wyr8(p) ^ wyp[1], wyr8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = wyr8(p + i - 16);
+		b = wyr8(p + i - 8);
+	}
+	a ^= wyp[1];
+	b ^= seed;
+	wymum(&a, &b);
+	return wymix(a ^ wyp[0] ^ len, b ^ wyp[1]);
+}
+
+/* wyhash of data that arrives in pieces: the 48 byte blocks are mixed as
+   soon as they are complete, and the end is left for wy_final(), which
+   may read back into the last block */
+typedef struct {
+	uint64_t seed, see1, see2;
+	uint64_t len;        /* bytes so far */
+	uint8_t buf[64];     /* the last 16 bytes of the last block, then those not mixed yet */
+	int n;               /* bytes not mixed yet, at buf + 16 */
+} wy_state;
+
+static void wy_init(wy_state *st, uint64_t seed)
+{
+	st->seed = st->see1 = st->see2 = seed ^ wymix(seed ^ wyp[0], wyp[1]);
+	st->len = 0;
+	st->n = 0;
+}
+
+static void wy_block(wy_state *st, const uint8_t *p)
+{
+	st->seed = wymix(wyr8(p) ^ wyp[1], wyr8(p + 8) ^ st->seed);
+	st->see1 = wymix(wyr8(p + 16) ^ wyp[2], wyr8(p + 24) ^ st->see1);
+	st->see2 = wymix(wyr8(p + 32) ^ wyp[3], wyr8(p + 40) ^ st->see2);
+}
+
+static void wy_update(wy_state *st, const uint8_t *p, size_t len)
+{
+	size_t take;
+
+	st->len += len;
+	if (st->n > 0) {
+		take = 48 - st->n;
+		if (take > len)
+			take = len;
+		memcpy(st->buf + 16 + st->n, p, take);
+		st->n += (int)take;
+		p += take;
+		len -= take;
+		if (st->n < 48)
+			return;
+		wy_block(st, st->buf + 16);
+		memcpy(st->buf, st->buf + 48, 16);
+		st->n = 0;
+	}
+	if (len >= 48) {
+		do {
+			wy_block(st, p);
+			p += 48;
+			len -= 48;
+		} while (len >= 48);
+		memcpy(st->buf, p - 16, 16);
+	}
+	memcpy(st->buf + 16, p, len);
+	st->n = (int)len;
+}
+
+static uint64_t wy_final(wy_state *st)
+{
+	uint8_t *p = st->buf + 16;
+	uint64_t a, b, seed = st->seed;
+	size_t i = st->n, len = st->len;
+
+	if (len <= 16) {
+		if (len >= 4) {
+			a = (wyr4(p) << 32) | wyr4(p + ((len >> 3) << 2));
+			b = (wyr4(p + len - 4) << 32) | wyr4(p + len - 4 - ((len >> 3) << 2));
+		}
+		else if (len > 0) {
+			a = wyr3(p, len);
+			b = 0;
+		}
+		else
+			a = b = 0;
+	}
+	else {
+		if (len >= 48)
+			seed ^= st->see1 ^ st->see2;
+		while (i > 16) {
+			seed = wymix(wyr8(p) ^ wyp[1], wyr8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = wyr8(p + i - 16);
+		b = wyr8(p + i - 8);
+	}
+	a ^= wyp[1];
+	b ^= seed;
+	wymum(&a, &b);
+	return wymix(a ^ wyp[0] ^ len, b ^ wyp[1]);
+}
+
+/* hash values are the top bits that fit in a Euphoria integer */
+#define WY_RESULT(h) MAKE_INT((h) >> (INTPTR_MAX == INT32_MAX ? 34 : 2))
+
+static uint64_t process_hash_seed()
+/* the seed of WYHASH_SEEDED: random, unless EUHASHSEED gives one */
+{
+	static uint64_t seed;
+	static int have_seed = FALSE;
+	char *env;
+#ifdef __unix
+	FILE *f;
+#elif defined(_WIN32)
+	typedef BOOLEAN (WINAPI *gen_random_t)(PVOID, ULONG);
+	gen_random_t gen_random;
+	HMODULE advapi;
+	uint64_t r;
+#endif
+
+	if (have_seed)
+		return seed;
+	have_seed = TRUE;
+	env = getenv("EUHASHSEED");
+	if (env != NULL && *env != '\0') {
+		seed = strtoull(env, NULL, 0);
+		return seed;
+	}
+	seed = wymix((uint64_t)time(NULL) ^ wyp[2], (uint64_t)clock() ^ (uintptr_t)&env);
+#ifdef __unix
+	seed ^= wymix((uint64_t)getpid(), wyp[3]);
+	f = fopen("/dev/urandom", "rb");
+	if (f != NULL) {
+		uint64_t r;
+		if (fread(&r, sizeof(r), 1, f) == 1)
+			seed ^= r;
+		fclose(f);
+	}
+#elif defined(_WIN32)
+	seed ^= wymix((uint64_t)GetCurrentProcessId(), wyp[3]);
+	/* RtlGenRandom, exported by that name only */
+	advapi = LoadLibrary("advapi32.dll");
+	if (advapi != NULL) {
+		gen_random = (gen_random_t)GetProcAddress(advapi, "SystemFunction036");
+		if (gen_random != NULL && gen_random(&r, sizeof(r)))
+			seed ^= r;
+		FreeLibrary(advapi);
+	}
+#endif
+	return seed;
+}
+
+static int wy_atom_int(object *x)
+/* turn an atom with an integer value into that integer; true if it is one */
+{
+	eudouble d;
+
+	if (IS_ATOM_INT(*x))
+		return TRUE;
+	if (IS_ATOM_DBL(*x)) {
+		d = DBL_PTR(*x)->dbl;
+		if (d >= MININT_DBL && d <= MAXINT_DBL && d == (eudouble)(object)d) {
+			*x = (object)d;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static int wy_is_bytes(s1_ptr s)
+/* true if every element of s is a byte */
+{
+	object_ptr p = s->base + 1, end = p + s->length;
+	object x;
+
+	for (; p < end; p++) {
+		x = *p;
+		if (!wy_atom_int(&x) || (uintptr_t)x > 255)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static void wy_bytes(wy_state *st, s1_ptr s)
+/* add the elements of s, all bytes, a chunk at a time */
+{
+	uint8_t chunk[256];
+	object_ptr p = s->base + 1;
+	intptr_t left = s->length, k, n;
+	object x;
+
+	while (left > 0) {
+		n = left < 256 ? left : 256;
+		for (k = 0; k < n; k++) {
+			x = p[k];
+			wy_atom_int(&x);
+			chunk[k] = (uint8_t)x;
+		}
+		wy_update(st, chunk, n);
+		p += n;
+		left -= n;
+	}
+}
+
+static void wy_u64(uint8_t *b, uint64_t v)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+		b[i] = (uint8_t)(v >> (8 * i));
+}
+
+static int wy_dbl(uint8_t *b, eudouble d)
+/* write the bytes of a non-integer atom to b and return how many: those of
+   the double when it holds the value exactly, else the sign, exponent and
+   whole mantissa, so that long doubles that differ hash differently */
+{
+	union {
+		double d;
+		uint64_t u;
+	} v;
+#if INTPTR_MAX != INT32_MAX
+	eudouble m;
+	uint64_t hi;
+	int e;
+#endif
+
+	v.d = (double)d;
+	if ((eudouble)v.d == d || d != d) {
+		wy_u64(b, v.u);
+		return 8;
+	}
+#if INTPTR_MAX != INT32_MAX
+	m = ldexpl(frexpl(d < 0 ? -d : d, &e), 64);
+	hi = (uint64_t)m;
+	wy_u64(b, hi);
+	wy_u64(b + 8, (uint64_t)ldexpl(m - (eudouble)hi, 64));
+	wy_u64(b + 16, ((uint64_t)(uint32_t)e << 1) | (d < 0));
+	return 24;
+#else
+	return 8;
+#endif
+}
+
+static void wy_atom(wy_state *st, object x)
+/* add an atom: a tag byte then its bytes */
+{
+	uint8_t b[25];
+	int n;
+
+	if (wy_atom_int(&x)) {
+		b[0] = 'i';
+		wy_u64(b + 1, (uint64_t)(int64_t)x);
+		n = 8;
+	}
+	else {
+		b[0] = 'd';
+		n = wy_dbl(b + 1, DBL_PTR(x)->dbl);
+	}
+	wy_update(st, b, 1 + n);
+}
+
+static void wy_object(wy_state *st, object x)
+/* add a sequence element: atoms and byte strings are tagged, and other
+   sequences are tagged, then their elements follow */
+{
+	uint8_t b[9];
+	s1_ptr s;
+	intptr_t i;
+
+	if (IS_ATOM(x)) {
+		wy_atom(st, x);
+		return;
+	}
+	s = SEQ_PTR(x);
+	b[0] = wy_is_bytes(s) ? 'b' : 's';
+	wy_u64(b + 1, (uint64_t)s->length);
+	wy_update(st, b, 9);
+	if (b[0] == 'b')
+		wy_bytes(st, s);
+	else {
+		for (i = 1; i <= s->length; i++)
+			wy_object(st, s->base[i]);
+	}
+}
+
+static object calc_wyhash(object a, uint64_t seed)
+/* wyhash of an atom's bytes, of a byte string's bytes, or of the
+   tagged elements of another sequence */
+{
+	uint8_t b[256];
+	wy_state st;
+	s1_ptr s;
+	intptr_t i;
+	object x;
+
+	if (IS_ATOM(a)) {
+		if (wy_atom_int(&a)) {
+			wy_u64(b, (uint64_t)(int64_t)a);
+			return WY_RESULT(wyhash(b, 8, seed));
+		}
+		return WY_RESULT(wyhash(b, wy_dbl(b, DBL_PTR(a)->dbl), seed));
+	}
+
+	s = SEQ_PTR(a);
+	if (wy_is_bytes(s)) {
+		if (s->length <= 256) {
+			for (i = 0; i < s->length; i++) {
+				x = s->base[i + 1];
+				wy_atom_int(&x);
+				b[i] = (uint8_t)x;
+			}
+			return WY_RESULT(wyhash(b, s->length, seed));
+		}
+		wy_init(&st, seed);
+		wy_bytes(&st, s);
+		return WY_RESULT(wy_final(&st));
+	}
+	wy_init(&st, seed);
+	for (i = 1; i <= s->length; i++)
+		wy_object(&st, s->base[i]);
+	return WY_RESULT(wy_final(&st));
+}
+
+/* hash_init(), hash_update() and hash_final() keep a wy_state in a
+   sequence of bytes, so it can be copied and dropped like any object */
+
+static void hash_state_get(object x, wy_state *st)
+{
+	s1_ptr s;
+	uint8_t *b = (uint8_t *)st;
+	size_t i;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != sizeof(wy_state))
+		RTFatal("not a hash state from hash_init()");
+	s = SEQ_PTR(x);
+	for (i = 0; i < sizeof(wy_state); i++) {
+		if (!IS_ATOM_INT(s->base[i + 1]))
+			RTFatal("not a hash state from hash_init()");
+		b[i] = (uint8_t)s->base[i + 1];
+	}
+}
+
+static object hash_state_new(wy_state *st)
+{
+	s1_ptr s;
+	uint8_t *b = (uint8_t *)st;
+	size_t i;
+
+	s = NewS1(sizeof(wy_state));
+	for (i = 0; i < sizeof(wy_state); i++)
+		s->base[i + 1] = b[i];
+	return MAKE_SEQ(s);
+}
+
+object hash_init(object x)
+/* machine_func(M_HASH_INIT, {algo, seed}) */
+{
+	wy_state st;
+	s1_ptr s;
+	object algo, seed;
+	uint64_t u;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 2)
+		RTFatal("hash_init expects {algo, seed}");
+	s = SEQ_PTR(x);
+	algo = s->base[1];
+	seed = s->base[2];
+	if (algo == -8)
+		u = process_hash_seed();
+	else if (algo == -7) {
+		if (IS_ATOM_INT(seed))
+			u = (uint64_t)(int64_t)seed;
+		else if (IS_ATOM_DBL(seed)) {
+			if (DBL_PTR(seed)->dbl < 0)
+				u = (uint64_t)(int64_t)DBL_PTR(seed)->dbl;
+			else
+				u = (uint64_t)DBL_PTR(seed)->dbl;
+		}
+		else
+			RTFatal("the seed of hash_init() must be an atom");
+	}
+	else
+		RTFatal("hash_init() supports WYHASH and WYHASH_SEEDED only");
+	memset(&st, 0, sizeof(st));
+	wy_init(&st, u);
+	return hash_state_new(&st);
+}
+
+object hash_update(object x)
+/* machine_func(M_HASH_UPDATE, {state, bytes}) */
+{
+	wy_state st;
+	s1_ptr s;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 2)
+		RTFatal("hash_update expects {state, bytes}");
+	s = SEQ_PTR(x);
+	hash_state_get(s->base[1], &st);
+	if (!IS_SEQUENCE(s->base[2]) || !wy_is_bytes(SEQ_PTR(s->base[2])))
+		RTFatal("hash_update() expects a sequence of bytes");
+	wy_bytes(&st, SEQ_PTR(s->base[2]));
+	return hash_state_new(&st);
+}
+
+object hash_final(object x)
+/* machine_func(M_HASH_FINAL, state) */
+{
+	wy_state st;
+
+	hash_state_get(x, &st);
+	return WY_RESULT(wy_final(&st));
+}
+
 #define rol(a,b) (((a) << b) | ((a) >> (32 - b)))
 object calc_hash(object a, object b)
 /* calculate the hash value of object a.
@@ -2951,6 +3570,9 @@ object calc_hash(object a, object b)
    b ==> -3 Fletcher-32
    b ==> -4 Adler-32
    b ==> -5 Hsieh-32
+   b ==> -6 Hsieh-30
+   b ==> -7 wyhash
+   b ==> -8 wyhash with the seed of this process
    b ==> >=0 and  <1 69096 + b
    b ==> >=1 hash = (hash * b + x)
 
@@ -2979,6 +3601,12 @@ object calc_hash(object a, object b)
 
 	IS_DOUBLE_AN_INTEGER(a)
 	if (IS_ATOM_INT(b)) {
+		if (b == -8)
+			return calc_wyhash(a, process_hash_seed());
+
+		if (b == -7)
+			return calc_wyhash(a, 0);
+
 		if (b == -6)
 			return calc_hsieh30(a);	// Will always return a Euphoria integer.
 
@@ -3152,88 +3780,507 @@ object calc_hash(object a, object b)
 
 }
 
-object compare(object a, object b)
-/* Compare general objects a and b. Return 0 if they are identical,
-   1 if a > b, -1 if a < b. All atoms are less than all sequences.
-   The INT-INT case *must* be taken care of by the caller */
+/* Intern table: one canonical copy of each interned string, so that
+   repeated values share storage and compare equal by pointer.
+   Open addressing with linear probing; each occupied slot owns one
+   reference to its string. */
+#define INTERN_MIN_SIZE 256
+static object *intern_slots = NULL;
+static uint32_t *intern_hashes = NULL;
+static uintptr_t intern_size = 0;
+static uintptr_t intern_count = 0;
+
+static void intern_insert(object x, uint32_t h)
+/* place x into a free slot; the table must have room */
 {
-	object_ptr ap, bp;
-	object av, bv;
-	int length, lengtha, lengthb;
-	eudouble da, db;
-	int c;
+	uintptr_t slot;
 
-	if (IS_ATOM(a)) {
-		if (!IS_ATOM(b))
-			return -1;
-		if (IS_ATOM_INT(a)) {
-			/* b *must* be a double */
-			da = (eudouble)a;
-			db = DBL_PTR(b)->dbl;
+	slot = h & (intern_size - 1);
+	while (intern_slots[slot] != 0)
+		slot = (slot + 1) & (intern_size - 1);
+	intern_slots[slot] = x;
+	intern_hashes[slot] = h;
+}
+
+static void intern_rebuild(uintptr_t new_size, int drop_unused)
+/* rehash into a table of new_size slots, optionally releasing strings
+   that are referenced by nothing but the table */
+{
+	object *old_slots;
+	uint32_t *old_hashes;
+	uintptr_t old_size, i;
+	object x;
+
+	old_slots = intern_slots;
+	old_hashes = intern_hashes;
+	old_size = intern_size;
+
+	intern_size = new_size;
+	intern_slots = (object *)EMalloc(new_size * sizeof(object));
+	intern_hashes = (uint32_t *)EMalloc(new_size * sizeof(uint32_t));
+	memset(intern_slots, 0, new_size * sizeof(object));
+	intern_count = 0;
+
+	for (i = 0; i < old_size; i++) {
+		x = old_slots[i];
+		if (x == 0)
+			continue;
+		if (drop_unused && SEQ_PTR(x)->ref == 1) {
+			DeRefDS(x);
+			continue;
 		}
-		else {
-			da = DBL_PTR(a)->dbl;
-			if (IS_ATOM_INT(b))
-				db = (eudouble)b;
-			else
-				db = DBL_PTR(b)->dbl;
+		intern_insert(x, old_hashes[i]);
+		intern_count++;
+	}
+	if (old_slots != NULL) {
+		EFree((char *)old_slots);
+		EFree((char *)old_hashes);
+	}
+}
+
+static object intern_string(object x)
+/* return (with a new reference) the canonical copy of string x */
+{
+	uint32_t h;
+	uintptr_t slot;
+	object y;
+	s1_ptr c;
+
+	if (intern_count * 4 >= intern_size * 3)
+		intern_rebuild(intern_size ? intern_size * 2 : INTERN_MIN_SIZE, FALSE);
+
+	h = calc_hsieh32(x);
+	slot = h & (intern_size - 1);
+	while ((y = intern_slots[slot]) != 0) {
+		if (y == x || (intern_hashes[slot] == h && equal(y, x))) {
+			RefDS(y);
+			return y;
 		}
-		return (da < db) ? -1: (da == db) ? 0: 1;
+		slot = (slot + 1) & (intern_size - 1);
+	}
+	if (in_arena(SEQ_PTR(x))) {
+		/* the table keeps its strings, so don't let one pin an arena chunk */
+		c = NewS1Heap(SEQ_PTR(x)->length);
+		memcpy(c->base + 1, SEQ_PTR(x)->base + 1, c->length * sizeof(object));
+		x = MAKE_SEQ(c);
+	}
+	else
+		RefDS(x);
+	intern_slots[slot] = x;
+	intern_hashes[slot] = h;
+	intern_count++;
+	RefDS(x);
+	return x;
+}
+
+static object intern_object(object x, int deep)
+/* intern x if it is a string. If deep, also intern every string found
+   inside x, copying only the sequences that change. */
+{
+	s1_ptr s, r;
+	object e, ie;
+	intptr_t i, j;
+
+	if (!IS_SEQUENCE(x)) {
+		Ref(x);
+		return x;
+	}
+	s = SEQ_PTR(x);
+	if (s->cleanup != 0) {
+		/* don't extend the life of objects with delete routines */
+		RefDS(x);
+		return x;
+	}
+	for (i = 1; i <= s->length; i++) {
+		if (!IS_ATOM_INT(s->base[i]))
+			break;
+	}
+	if (i > s->length)
+		return intern_string(x);
+	if (!deep) {
+		RefDS(x);
+		return x;
 	}
 
-	else {
-		/* a must be a SEQUENCE */
-		if (!IS_SEQUENCE(b))
-			return 1;
-		a = (object)SEQ_PTR(a);
-		b = (object)SEQ_PTR(b);
-		ap = ((s1_ptr)a)->base;
-		bp = ((s1_ptr)b)->base;
-		lengtha = ((s1_ptr)a)->length;
-		lengthb = ((s1_ptr)b)->length;
-		if (lengtha < lengthb)
-			length = lengtha;
-		else
-			length = lengthb;
-		while (--length >= 0) {
-			ap++;
-			bp++;
-			av = *ap;
-			bv = *bp;
-			if (av != bv) {
-				if (IS_ATOM_INT(av) && IS_ATOM_INT(bv)) {
-					if (av < bv)
-						return -1;
-					else
-						return 1;
-				}
-				else {
-					c = compare(av, bv);
-					if (c != 0)
-						return c;
-				}
+	r = NULL;
+	for (i = 1; i <= s->length; i++) {
+		e = s->base[i];
+		if (!IS_SEQUENCE(e))
+			continue;
+		ie = intern_object(e, deep);
+		if (ie == e) {
+			DeRefDS(ie);
+			continue;
+		}
+		if (r == NULL) {
+			r = NewS1(s->length);
+			for (j = 1; j <= s->length; j++) {
+				r->base[j] = s->base[j];
+				Ref(r->base[j]);
 			}
 		}
-		return (lengtha < lengthb) ? -1: (lengtha == lengthb) ? 0: 1;
+		DeRefDS(r->base[i]);
+		r->base[i] = ie;
 	}
+	if (r == NULL) {
+		RefDS(x);
+		return x;
+	}
+	return MAKE_SEQ(r);
 }
 
-
-object find(object a, s1_ptr b)
-/* find object a as an element of sequence b */
+object intern(object x)
+/* machine_func(M_INTERN, {x, deep}) */
 {
-	object_ptr bp;
-	object bv;
+	s1_ptr s;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 2)
+		RTFatal("intern expects {object, deep}");
+	s = SEQ_PTR(x);
+	return intern_object(s->base[1], IS_ATOM_INT(s->base[2]) && s->base[2] != 0);
+}
+
+object intern_purge()
+/* release interned strings that are no longer used elsewhere;
+   returns how many were released */
+{
+	uintptr_t before;
+
+	if (intern_size == 0)
+		return ATOM_0;
+	before = intern_count;
+	intern_rebuild(intern_size, TRUE);
+	return MAKE_UINT(before - intern_count);
+}
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__ILP32__) && \
+	(__GNUC__ >= 5 || defined(__clang__))
+#define SCAN_SIMD
+#include <immintrin.h>
+
+/* The diff scans return the first of the n objects at p that differs from
+   the object in the same place at q, or p + n if there is none. Equal words
+   are equal objects, so runs of equal integers and shared elements are
+   skipped without looking at their tags. */
+
+typedef object_ptr (*diff_scan_t)(object_ptr p, object_ptr q, intptr_t n);
+
+static object_ptr diff_scan_sse2(object_ptr p, object_ptr q, intptr_t n)
+{
+	object_ptr end = p + n;
+	int mask;
+
+	for (; end - p >= 2; p += 2, q += 2) {
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i *)p),
+												_mm_loadu_si128((__m128i *)q)));
+		if (mask != 0xFFFF)
+			return p + (__builtin_ctz(~mask) >> 3);
+	}
+	if (p < end && *p == *q)
+		p++;
+	return p;
+}
+
+__attribute__((target("avx2")))
+static object_ptr diff_scan_avx2(object_ptr p, object_ptr q, intptr_t n)
+{
+	object_ptr end = p + n;
+	unsigned int mask;
+
+	for (; end - p >= 4; p += 4, q += 4) {
+		mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i *)p),
+													  _mm256_loadu_si256((__m256i *)q)));
+		if (mask != 0xFFFFFFFF)
+			return p + (__builtin_ctz(~mask) >> 3);
+	}
+	return diff_scan_sse2(p, q, end - p);
+}
+
+__attribute__((target("avx512f")))
+static object_ptr diff_scan_avx512(object_ptr p, object_ptr q, intptr_t n)
+{
+	object_ptr end = p + n;
+	__mmask8 mask;
+
+	for (; end - p >= 8; p += 8, q += 8) {
+		mask = _mm512_cmpneq_epi64_mask(_mm512_loadu_si512((void *)p),
+										_mm512_loadu_si512((void *)q));
+		if (mask)
+			return p + __builtin_ctz(mask);
+	}
+	return diff_scan_sse2(p, q, end - p);
+}
+
+static object_ptr diff_scan_init(object_ptr p, object_ptr q, intptr_t n);
+static diff_scan_t diff_scan = diff_scan_init;
+
+static object_ptr diff_scan_init(object_ptr p, object_ptr q, intptr_t n)
+/* picks the widest scan this processor can run, on the first call */
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		diff_scan = diff_scan_avx512;
+	else if (__builtin_cpu_supports("avx2"))
+		diff_scan = diff_scan_avx2;
+	else
+		diff_scan = diff_scan_sse2;
+	return diff_scan(p, q, n);
+}
+#endif
+
+/* shorter runs are compared one word at a time */
+#define DIFF_SCAN_MIN 8
+
+static intptr_t first_diff(object_ptr p, object_ptr q, intptr_t n)
+/* index from 0 of the first of the n objects at p that is not the same
+   word as the object in the same place at q, or n */
+{
+	intptr_t i;
+
+#ifdef SCAN_SIMD
+	if (n >= DIFF_SCAN_MIN)
+		return diff_scan(p, q, n) - p;
+#endif
+	for (i = 0; i < n && p[i] == q[i]; i++)
+		;
+	return i;
+}
+
+object compare(object a, object b)
+/* Compare general objects a and b. Return 0 if they are identical,
+   1 if a > b, -1 if a < b. All atoms are less than all sequences.
+   The INT-INT case *must* be taken care of by the caller */
+{
+	object_ptr ap, bp;
+	object av, bv;
+	intptr_t length, lengtha, lengthb, i;
+	eudouble da, db;
+	int c;
+
+	if (IS_ATOM(a)) {
+		if (!IS_ATOM(b))
+			return -1;
+		if (IS_ATOM_INT(a)) {
+			/* b *must* be a double */
+			da = (eudouble)a;
+			db = DBL_PTR(b)->dbl;
+		}
+		else {
+			da = DBL_PTR(a)->dbl;
+			if (IS_ATOM_INT(b))
+				db = (eudouble)b;
+			else
+				db = DBL_PTR(b)->dbl;
+		}
+		return (da < db) ? -1: (da == db) ? 0: 1;
+	}
+
+	else {
+		/* a must be a SEQUENCE */
+		if (!IS_SEQUENCE(b))
+			return 1;
+		if (a == b)
+			return 0;  /* same sequence, e.g. interned strings */
+		a = (object)SEQ_PTR(a);
+		b = (object)SEQ_PTR(b);
+		ap = ((s1_ptr)a)->base + 1;
+		bp = ((s1_ptr)b)->base + 1;
+		lengtha = ((s1_ptr)a)->length;
+		lengthb = ((s1_ptr)b)->length;
+		if (lengtha < lengthb)
+			length = lengtha;
+		else
+			length = lengthb;
+		while (length > 0) {
+			/* skip to the first pair of elements that differ */
+			i = first_diff(ap, bp, length);
+			if (i == length)
+				break;
+			av = ap[i];
+			bv = bp[i];
+			if (IS_ATOM_INT(av) && IS_ATOM_INT(bv)) {
+				if (av < bv)
+					return -1;
+				else
+					return 1;
+			}
+			c = compare(av, bv);
+			if (c != 0)
+				return c;
+			ap += i + 1;
+			bp += i + 1;
+			length -= i + 1;
+		}
+		return (lengtha < lengthb) ? -1: (lengtha == lengthb) ? 0: 1;
+	}
+}
+
+object equal(object a, object b)
+/* Return 1 if objects a and b are equal as compare() sees them, else 0.
+   Unlike compare() it gives up as soon as two sequence lengths differ. */
+{
+	object_ptr ap, bp;
+	object av, bv;
+	intptr_t length, i;
+
+	if (a == b)
+		return ATOM_1;  /* same integer, same double or same sequence */
 
+	if (IS_ATOM_INT(a)) {
+		if (IS_ATOM_INT(b) || IS_SEQUENCE(b))
+			return ATOM_0;
+		return (eudouble)a == DBL_PTR(b)->dbl;
+	}
+
+	if (IS_ATOM_DBL(a)) {
+		if (IS_ATOM_INT(b))
+			return DBL_PTR(a)->dbl == (eudouble)b;
+		if (IS_SEQUENCE(b))
+			return ATOM_0;
+		return DBL_PTR(a)->dbl == DBL_PTR(b)->dbl;
+	}
+
+	/* a must be a SEQUENCE */
 	if (!IS_SEQUENCE(b))
-		RTFatal("second argument of find() must be a sequence");
+		return ATOM_0;
+	length = SEQ_PTR(a)->length;
+	if (length != SEQ_PTR(b)->length)
+		return ATOM_0;
+	ap = SEQ_PTR(a)->base + 1;
+	bp = SEQ_PTR(b)->base + 1;
+	while (length > 0) {
+		i = first_diff(ap, bp, length);
+		if (i == length)
+			break;
+		av = ap[i];
+		bv = bp[i];
+		if (IS_ATOM_INT(av) && IS_ATOM_INT(bv))
+			return ATOM_0;
+		if (!equal(av, bv))
+			return ATOM_0;
+		ap += i + 1;
+		bp += i + 1;
+		length -= i + 1;
+	}
+	return ATOM_1;
+}
 
-	b = SEQ_PTR(b);
-	bp = b->base;
+
+#ifdef SCAN_SIMD
+/* The scans below return the first of the n objects at p that is equal to
+   the integer a or is not an integer, or p + n if there is none.
+   An object is an integer when its top two bits are the same, so
+   x ^ (x << 1) has its sign bit set for doubles and sequences. */
+
+typedef object_ptr (*find_scan_t)(object_ptr p, intptr_t n, object a);
+
+static object_ptr find_scan_sse2(object_ptr p, intptr_t n, object a)
+{
+	object_ptr end = p + n;
+	__m128i needle = _mm_set1_epi64x(a);
+	__m128i v, eq;
+	int mask;
+
+	for (; end - p >= 2; p += 2) {
+		v = _mm_loadu_si128((__m128i *)p);
+		/* no 64 bit compare in SSE2: both 32 bit halves must be equal */
+		eq = _mm_cmpeq_epi32(v, needle);
+		eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+		v = _mm_or_si128(eq, _mm_xor_si128(v, _mm_slli_epi64(v, 1)));
+		mask = _mm_movemask_pd(_mm_castsi128_pd(v));
+		if (mask)
+			return p + __builtin_ctz(mask);
+	}
+	for (; p < end; p++) {
+		if (*p == a || !IS_ATOM_INT(*p))
+			return p;
+	}
+	return end;
+}
+
+__attribute__((target("avx2")))
+static object_ptr find_scan_avx2(object_ptr p, intptr_t n, object a)
+{
+	object_ptr end = p + n;
+	__m256i needle = _mm256_set1_epi64x(a);
+	__m256i v;
+	int mask;
+
+	for (; end - p >= 4; p += 4) {
+		v = _mm256_loadu_si256((__m256i *)p);
+		v = _mm256_or_si256(_mm256_cmpeq_epi64(v, needle),
+							_mm256_xor_si256(v, _mm256_slli_epi64(v, 1)));
+		mask = _mm256_movemask_pd(_mm256_castsi256_pd(v));
+		if (mask)
+			return p + __builtin_ctz(mask);
+	}
+	return find_scan_sse2(p, end - p, a);
+}
+
+__attribute__((target("avx512f")))
+static object_ptr find_scan_avx512(object_ptr p, intptr_t n, object a)
+{
+	object_ptr end = p + n;
+	__m512i needle = _mm512_set1_epi64(a);
+	__m512i v;
+	__mmask8 mask;
+
+	for (; end - p >= 8; p += 8) {
+		v = _mm512_loadu_si512((void *)p);
+		mask = _mm512_cmpeq_epi64_mask(v, needle) |
+			   _mm512_cmplt_epi64_mask(_mm512_xor_si512(v, _mm512_slli_epi64(v, 1)),
+									   _mm512_setzero_si512());
+		if (mask)
+			return p + __builtin_ctz(mask);
+	}
+	return find_scan_sse2(p, end - p, a);
+}
+
+static object_ptr find_scan_init(object_ptr p, intptr_t n, object a);
+static find_scan_t find_scan = find_scan_init;
+
+static object_ptr find_scan_init(object_ptr p, intptr_t n, object a)
+/* picks the widest scan this processor can run, on the first call */
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		find_scan = find_scan_avx512;
+	else if (__builtin_cpu_supports("avx2"))
+		find_scan = find_scan_avx2;
+	else
+		find_scan = find_scan_sse2;
+	return find_scan(p, n, a);
+}
+#endif
+
+static object find_in(object a, s1_ptr b, object_ptr bp)
+/* find object a as an element of sequence b, after the element at bp */
+{
+	object bv;
 
 	if (IS_ATOM_INT(a)) {
 		eudouble da = (eudouble)0;
 		int daok = 0;
+#ifdef SCAN_SIMD
+		object_ptr end = b->base + b->length + 1;
+
+		for (bp++; bp < end; bp++) {
+			bp = find_scan(bp, end - bp, a);
+			if (bp == end)
+				break;
+			bv = *bp;
+			if (bv == a)
+				return bp - (object_ptr)b->base;
+			if (IS_ATOM_DBL(bv)) {  /* INT-DBL case */
+				if (! daok) {
+					da = (eudouble)a;
+					daok = 1;
+				}
+				if (da == DBL_PTR(bv)->dbl)
+					return bp - (object_ptr)b->base;
+			}
+		}
+#else
 		while (TRUE) {
 			bv = *(++bp);
 			if (IS_ATOM_INT(bv)) {
@@ -3255,6 +4302,7 @@ object find(object a, s1_ptr b)
 					return bp - (object_ptr)b->base;
 			}
 		}
+#endif
 	}
 
 	else if (IS_ATOM_DBL(a)) {
@@ -3292,7 +4340,7 @@ object find(object a, s1_ptr b)
 			if (IS_SEQUENCE(bv)) {
 				if (a_len == SEQ_PTR(bv)->length) {
 					/* a is SEQUENCE => not INT-INT case */
-					if (compare(a, bv) == 0)
+					if (equal(a, bv))
 						return bp - (object_ptr)b->base;
 				}
 			}
@@ -3302,35 +4350,199 @@ object find(object a, s1_ptr b)
 	return 0;
 }
 
+object find(object a, s1_ptr b)
+/* find object a as an element of sequence b */
+{
+	if (!IS_SEQUENCE(b))
+		RTFatal("second argument of find() must be a sequence");
+
+	b = SEQ_PTR(b);
+	return find_in(a, b, b->base);
+}
+
 
-object e_match(s1_ptr a, s1_ptr b)
-/* find sequence a as a slice within sequence b
+/* a, an integer of a needle, is equal to b of a haystack as compare() sees it */
+#define MATCH_EQ(a, b) ((a) == (b) || \
+	(!IS_ATOM_INT(b) && IS_ATOM_DBL(b) && (eudouble)(a) == DBL_PTR(b)->dbl))
+
+/* longest needle searched with Horspool, whose worst case is O(n * m) */
+#define HORSPOOL_MAX 32
+
+static intptr_t horspool(object_ptr x, intptr_t m, object_ptr y, intptr_t n)
+/* Boyer-Moore-Horspool search for the m integers 0..255 at x in the n
+   objects at y. Returns the index from 0 of the first match, or -1. */
+{
+	intptr_t shift[256];
+	intptr_t i, j, k;
+	object c;
+	eudouble d;
+
+	for (i = 0; i < 256; i++)
+		shift[i] = m;
+	for (i = 0; i < m - 1; i++)
+		shift[x[i]] = m - 1 - i;
+
+	for (j = 0; j <= n - m; j += k) {
+		for (i = m - 1; i >= 0 && MATCH_EQ(x[i], y[j + i]); i--)
+			;
+		if (i < 0)
+			return j;
+
+		/* shift by the last object of the window, which can only be
+		   in the needle if it is an integer 0..255 */
+		c = y[j + m - 1];
+		k = m;
+		if (IS_ATOM_INT(c)) {
+			if (c >= 0 && c < 256)
+				k = shift[c];
+		}
+		else if (IS_ATOM_DBL(c)) {
+			d = DBL_PTR(c)->dbl;
+			if (d >= 0 && d < 256 && d == (eudouble)(intptr_t)d)
+				k = shift[(intptr_t)d];
+		}
+	}
+	return -1;
+}
+
+static intptr_t max_suffix(object_ptr x, intptr_t m, intptr_t *period, int reverse)
+/* start - 1 and period of the maximal suffix of x, in the order of the
+   integers if reverse is 0, or in the opposite order */
+{
+	intptr_t ms = -1, j = 0, k = 1, p = 1;
+	object a, b;
+
+	while (j + k < m) {
+		a = x[j + k];
+		b = x[ms + k];
+		if (reverse ? a > b : a < b) {
+			j += k;
+			k = 1;
+			p = j - ms;
+		}
+		else if (a == b) {
+			if (k != p)
+				++k;
+			else {
+				j += p;
+				k = 1;
+			}
+		}
+		else {
+			ms = j;
+			j = ms + 1;
+			k = p = 1;
+		}
+	}
+	*period = p;
+	return ms;
+}
+
+static intptr_t two_way(object_ptr x, intptr_t m, object_ptr y, intptr_t n)
+/* Crochemore-Perrin Two-Way search for the m integers at x in the n
+   objects at y, in linear time. Returns the index from 0 of the first
+   match, or -1. */
+{
+	intptr_t i, j, ell, memory, per, p, q;
+
+	i = max_suffix(x, m, &p, 0);
+	j = max_suffix(x, m, &q, 1);
+	if (i > j) {
+		ell = i;
+		per = p;
+	}
+	else {
+		ell = j;
+		per = q;
+	}
+
+	if (memcmp(x, x + per, (ell + 1) * sizeof(object)) == 0) {
+		/* periodic needle: remember how much of the left part matched */
+		memory = -1;
+		for (j = 0; j <= n - m; ) {
+			i = ((ell > memory) ? ell : memory) + 1;
+			while (i < m && MATCH_EQ(x[i], y[i + j]))
+				++i;
+			if (i >= m) {
+				i = ell;
+				while (i > memory && MATCH_EQ(x[i], y[i + j]))
+					--i;
+				if (i <= memory)
+					return j;
+				j += per;
+				memory = m - per - 1;
+			}
+			else {
+				j += i - ell;
+				memory = -1;
+			}
+		}
+	}
+	else {
+		per = ((ell + 1 > m - ell - 1) ? ell + 1 : m - ell - 1) + 1;
+		for (j = 0; j <= n - m; ) {
+			i = ell + 1;
+			while (i < m && MATCH_EQ(x[i], y[i + j]))
+				++i;
+			if (i >= m) {
+				i = ell;
+				while (i >= 0 && MATCH_EQ(x[i], y[i + j]))
+					--i;
+				if (i < 0)
+					return j;
+				j += per;
+			}
+			else
+				j += i - ell;
+		}
+	}
+	return -1;
+}
+
+static object match_in(s1_ptr a, s1_ptr b, object_ptr bp)
+/* find sequence a as a slice within sequence b, after the element at bp.
    sequence a may not be empty */
 {
 	int ntries, len_remaining;
-	object_ptr a1, b1, bp;
+	object_ptr a1, b1;
 	object_ptr ai, bi;
 	object av, bv;
-	int lengtha, lengthb;
+	intptr_t i, m, n;
+	int small;
 
-	if (!IS_SEQUENCE(a))
-		RTFatal("first argument of match() must be a sequence");
-	if (!IS_SEQUENCE(b))
-		RTFatal("second argument of match() must be a sequence");
-	a = SEQ_PTR(a);
-	b = SEQ_PTR(b);
-	lengtha = a->length;
-	if (lengtha == 0)
-		RTFatal("first argument of match() must be a non-empty sequence");
-	lengthb = b->length;
 	b1 = b->base;
-	bp = b1;
 	a1 = a->base;
-	ntries = lengthb - lengtha + 1;
+	m = a->length;
+	n = b->length - (bp - b1);
+
+	/* a needle of integers can be searched for in linear time */
+	small = TRUE;
+	for (i = 1; i <= m; i++) {
+		if (!IS_ATOM_INT(a1[i]))
+			break;
+		if (a1[i] < 0 || a1[i] > 255)
+			small = FALSE;
+	}
+	if (i > m && n >= m) {
+		if (m == 1)
+			return find_in(a1[1], b, bp);
+		if (small && m <= HORSPOOL_MAX) {
+			if (n >= 256) {
+				i = horspool(a1 + 1, m, bp + 1, n);
+				return (i < 0) ? 0 : bp - b1 + i + 1;
+			}
+		}
+		else {
+			i = two_way(a1 + 1, m, bp + 1, n);
+			return (i < 0) ? 0 : bp - b1 + i + 1;
+		}
+	}
+
+	ntries = n - m + 1;
 	while (--ntries >= 0) {
 		ai = a1;
 		bi = bp;
-		len_remaining = lengtha;
+		len_remaining = m;
 		do {
 			ai++;
 			bi++;
@@ -3353,6 +4565,21 @@ object e_match(s1_ptr a, s1_ptr b)
 	return 0; /* couldn't match */
 }
 
+object e_match(s1_ptr a, s1_ptr b)
+/* find sequence a as a slice within sequence b
+   sequence a may not be empty */
+{
+	if (!IS_SEQUENCE(a))
+		RTFatal("first argument of match() must be a sequence");
+	if (!IS_SEQUENCE(b))
+		RTFatal("second argument of match() must be a sequence");
+	a = SEQ_PTR(a);
+	b = SEQ_PTR(b);
+	if (a->length == 0)
+		RTFatal("first argument of match() must be a non-empty sequence");
+	return match_in(a, b, b->base);
+}
+
 #ifndef ERUNTIME
 static void CheckSlice(object a, int startval, int endval, int length)
 /* check legality of a slice, return integer values of start, length */
@@ -4063,47 +5290,405 @@ static void indent()
 }
 
 
-static void rPrint(object a)
-/* print any object in default numeric format */
-{
-	int length;
-	int multi_line;
-	object_ptr elem;
-	char sbuff[NUM_SIZE];
-
-	if (print_lines == 0)
-		return;
+/* Atoms are printed with the fewest digits that read back as the same
+   atom, by the free-format algorithm of Steele & White as refined by
+   Burger & Dybvig, on small big numbers. Values with at most 10 digits
+   come out as %.10g would print them. */
 
-	if (IS_ATOM(a)) {
-		if (IS_ATOM_INT(a)) {
-			snprintf(sbuff, NUM_SIZE, "%" PRIdPTR, a);
-			sbuff[NUM_SIZE-1] = 0; // ensure NULL
-			screen_output(print_file, sbuff);
-			print_chars += strlen(sbuff);
-			if (show_ascii && a >= ' ' &&
-#ifdef __unix
-				a <= 126)  // DEL is a problem with ANSI code display
-#else
-				a <= 127)
-#endif
-				print_chars += show_ascii_char(print_file, a);
-		}
-                else if (a == NOVALUE) {
-                        screen_output(print_file, "NOVALUE" );
-                        print_chars += strlen("NOVALUE");
-                }
-		else {
 #if INTPTR_MAX == INT32_MAX
-			snprintf(sbuff, NUM_SIZE, "%.10g", DBL_PTR(a)->dbl);
+#define EU_MANT_DIG DBL_MANT_DIG
+#define EU_MIN_EXP DBL_MIN_EXP
+#define EUFREXP frexp
+#define EULDEXP ldexp
+#define EUSTRTOD strtod
 #else
-			snprintf(sbuff, NUM_SIZE, "%.10Lg", DBL_PTR(a)->dbl);
+#define EU_MANT_DIG LDBL_MANT_DIG
+#define EU_MIN_EXP LDBL_MIN_EXP
+#define EUFREXP frexpl
+#define EULDEXP ldexpl
+#define EUSTRTOD strtold
 #endif
-			sbuff[NUM_SIZE-1] = 0; // ensure NULL
-			screen_output(print_file, sbuff);
-			print_chars += strlen(sbuff);
-		}
-	}
-	else {
+
+/* enough 32-bit words for 2 ** 16500 times the mantissa */
+#define BIG_WORDS 560
+
+typedef struct {
+	int n;              /* words in use */
+	uint32_t w[BIG_WORDS]; /* least significant first */
+} bignum;
+
+static void big_mul_small(bignum *a, uint32_t m)
+{
+	uint64_t carry = 0;
+	int i;
+
+	for (i = 0; i < a->n; i++) {
+		carry += (uint64_t)a->w[i] * m;
+		a->w[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	if (carry)
+		a->w[a->n++] = (uint32_t)carry;
+}
+
+static void big_mul_pow10(bignum *a, int k)
+{
+	static const uint32_t pow10[] = { 1, 10, 100, 1000, 10000, 100000,
+		1000000, 10000000, 100000000, 1000000000 };
+
+	for (; k >= 9; k -= 9)
+		big_mul_small(a, pow10[9]);
+	if (k > 0)
+		big_mul_small(a, pow10[k]);
+}
+
+static void big_shl(bignum *a, int bits)
+{
+	int words = bits / 32, i;
+
+	bits %= 32;
+	if (bits) {
+		a->w[a->n] = 0;
+		for (i = a->n; i > 0; i--)
+			a->w[i] = (a->w[i] << bits) | (a->w[i - 1] >> (32 - bits));
+		a->w[0] <<= bits;
+		if (a->w[a->n])
+			a->n++;
+	}
+	if (words) {
+		memmove(a->w + words, a->w, a->n * sizeof(uint32_t));
+		memset(a->w, 0, words * sizeof(uint32_t));
+		a->n += words;
+	}
+}
+
+static void big_add(bignum *sum, bignum *a, bignum *b)
+/* sum = a + b */
+{
+	uint64_t carry = 0;
+	int i;
+
+	if (a->n < b->n) {
+		bignum *t = a;
+		a = b;
+		b = t;
+	}
+	for (i = 0; i < a->n; i++) {
+		carry += a->w[i];
+		if (i < b->n)
+			carry += b->w[i];
+		sum->w[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	sum->n = a->n;
+	if (carry)
+		sum->w[sum->n++] = (uint32_t)carry;
+}
+
+static void big_sub(bignum *a, bignum *b)
+/* a -= b, where b <= a */
+{
+	int64_t borrow = 0;
+	int i;
+
+	for (i = 0; i < a->n; i++) {
+		borrow += a->w[i];
+		if (i < b->n)
+			borrow -= b->w[i];
+		a->w[i] = (uint32_t)borrow;
+		borrow = (borrow < 0) ? -1 : 0;
+	}
+	while (a->n > 0 && a->w[a->n - 1] == 0)
+		a->n--;
+}
+
+static int big_cmp(bignum *a, bignum *b)
+{
+	int i;
+
+	if (a->n != b->n)
+		return (a->n < b->n) ? -1 : 1;
+	for (i = a->n - 1; i >= 0; i--) {
+		if (a->w[i] != b->w[i])
+			return (a->w[i] < b->w[i]) ? -1 : 1;
+	}
+	return 0;
+}
+
+static int ShortestDigits(eudouble v, char *digits, int *exp10)
+/* the shortest digits d1d2...dn of positive, finite v, where 0.d1d2...dn
+   times 10 ** exp10 reads back as v. Returns n. */
+{
+	bignum r, s, mplus, mminus, t;
+	int e, k, n, i, even, low, high, d, narrow;
+	eudouble x;
+#if EU_MANT_DIG <= 64
+	uint64_t f;
+#else
+	uint32_t w;
+#endif
+
+	/* v is f * 2 ** e, with f an integer of EU_MANT_DIG bits */
+	x = EUFREXP(v, &e);
+	k = e; /* v < 2 ** k */
+	e -= EU_MANT_DIG;
+	x = EULDEXP(x, EU_MANT_DIG);
+	if (e < EU_MIN_EXP - EU_MANT_DIG) {
+		/* denormal */
+		x = EULDEXP(x, e - (EU_MIN_EXP - EU_MANT_DIG));
+		e = EU_MIN_EXP - EU_MANT_DIG;
+	}
+	/* the gap to the next smaller value is half the gap to the next
+	   larger one when f is the smallest full mantissa */
+	narrow = x == EULDEXP(1, EU_MANT_DIG - 1) && e > EU_MIN_EXP - EU_MANT_DIG;
+
+	/* the number of digits before the point, or one too few */
+	k = (int)ceil((k - 1) * 0.30102999566398119521 - 1e-10);
+
+#if defined(__SIZEOF_INT128__) && EU_MANT_DIG <= 64
+	f = (uint64_t)x;
+	even = (f & 1) == 0;
+	if (EU_MANT_DIG + 2 + ((e > 0) ? e : 0) + ((k < 0) ? -k * 10 / 3 + 1 : 0) <= 116 &&
+		3 + ((e < 0) ? -e : 0) + ((k > 0) ? k * 10 / 3 + 1 : 0) <= 116) {
+		/* usually everything fits in 128 bits */
+		static const uint64_t pow10[] = { 1ULL, 10ULL, 100ULL, 1000ULL,
+			10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+			1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+			10000000000000ULL, 100000000000000ULL, 1000000000000000ULL,
+			10000000000000000ULL, 100000000000000000ULL,
+			1000000000000000000ULL, 10000000000000000000ULL };
+		unsigned __int128 r2, s2, mp2, mm2, p;
+		double inv;
+		int sh;
+
+		r2 = (unsigned __int128)f << (1 + narrow);
+		s2 = 2 << narrow;
+		mm2 = 1;
+		if (e >= 0) {
+			r2 <<= e;
+			mm2 <<= e;
+		}
+		else
+			s2 <<= -e;
+		mp2 = mm2 << narrow;
+		i = (k < 0) ? -k : k;
+		p = (i < 20) ? pow10[i] : (unsigned __int128)pow10[19] * pow10[i - 19];
+		if (k >= 0)
+			s2 *= p;
+		else {
+			r2 *= p;
+			mp2 *= p;
+			mm2 *= p;
+		}
+		if (even ? r2 + mp2 >= s2 : r2 + mp2 > s2) {
+			k++;
+			s2 *= 10;
+		}
+		*exp10 = k;
+
+		/* r2 stays below 10 * s2, and estimating r2 / s2 from their top
+		   63 bits is off by at most 1 */
+		sh = (s2 >> 64) ? 128 - __builtin_clzll((uint64_t)(s2 >> 64)) : 64 - __builtin_clzll((uint64_t)s2);
+		sh = (sh > 59) ? sh - 59 : 0;
+		inv = 1.0 / (double)(int64_t)(s2 >> sh);
+		n = 0;
+		do {
+			r2 *= 10;
+			mp2 *= 10;
+			mm2 *= 10;
+			d = (int)((double)(int64_t)(r2 >> sh) * inv);
+			if ((unsigned __int128)d * s2 > r2)
+				d--;
+			else if (r2 - (unsigned __int128)d * s2 >= s2)
+				d++;
+			r2 -= (unsigned __int128)d * s2;
+			low = even ? r2 <= mm2 : r2 < mm2;
+			high = even ? r2 + mp2 >= s2 : r2 + mp2 > s2;
+			if (low && high) {
+				/* both are close enough, take the nearer */
+				if (2 * r2 >= s2)
+					d++;
+			}
+			else if (high)
+				d++;
+			digits[n++] = '0' + d;
+		} while (!low && !high);
+		return n;
+	}
+#endif
+
+#if EU_MANT_DIG <= 64
+	f = (uint64_t)x;
+	r.n = 2;
+	r.w[0] = (uint32_t)f;
+	r.w[1] = (uint32_t)(f >> 32);
+#else
+	r.n = (EU_MANT_DIG + 31) / 32;
+	for (i = r.n - 1; i >= 0; i--) {
+		w = (uint32_t)EULDEXP(x, -32 * i);
+		r.w[i] = w;
+		x -= EULDEXP((eudouble)w, 32 * i);
+	}
+#endif
+	while (r.n > 0 && r.w[r.n - 1] == 0)
+		r.n--;
+	even = (r.w[0] & 1) == 0;
+
+	/* v = r / s, the next larger value is (r + mplus) / s, the next
+	   smaller one (r - mminus) / s */
+	s.n = 1;
+	s.w[0] = 2 << narrow;
+	mminus.n = 1;
+	mminus.w[0] = 1;
+	big_shl(&r, 1 + narrow);
+	if (e >= 0) {
+		big_shl(&r, e);
+		big_shl(&mminus, e);
+	}
+	else
+		big_shl(&s, -e);
+	mplus.n = mminus.n;
+	memcpy(mplus.w, mminus.w, mminus.n * sizeof(uint32_t));
+	big_shl(&mplus, narrow);
+
+	/* scale v to 0.d1d2... */
+	if (k >= 0)
+		big_mul_pow10(&s, k);
+	else {
+		big_mul_pow10(&r, -k);
+		big_mul_pow10(&mplus, -k);
+		big_mul_pow10(&mminus, -k);
+	}
+	big_add(&t, &r, &mplus);
+	if (even ? big_cmp(&t, &s) >= 0 : big_cmp(&t, &s) > 0) {
+		k++;
+		big_mul_small(&s, 10);
+	}
+	*exp10 = k;
+
+	n = 0;
+	do {
+		big_mul_small(&r, 10);
+		big_mul_small(&mplus, 10);
+		big_mul_small(&mminus, 10);
+		d = 0;
+		while (big_cmp(&r, &s) >= 0) {
+			big_sub(&r, &s);
+			d++;
+		}
+		i = big_cmp(&r, &mminus);
+		low = even ? i <= 0 : i < 0;
+		big_add(&t, &r, &mplus);
+		i = big_cmp(&t, &s);
+		high = even ? i >= 0 : i > 0;
+		if (low && high) {
+			/* both are close enough, take the nearer */
+			big_add(&t, &r, &r);
+			if (big_cmp(&t, &s) >= 0)
+				d++;
+		}
+		else if (high)
+			d++;
+		digits[n++] = '0' + d;
+	} while (!low && !high);
+	return n;
+}
+
+static void FormatAtom(char *buff, int len, eudouble v)
+/* write v into buff, as %.10g would but with as many digits as it takes
+   to read back as v */
+{
+	char digits[48];
+	char *p;
+	int n, k, x, i;
+
+	if (v == 0 || v != v || v - v != 0) {
+		/* 0, nan and inf */
+#if INTPTR_MAX == INT32_MAX
+		snprintf(buff, len, "%.10g", v);
+#else
+		snprintf(buff, len, "%.10Lg", v);
+#endif
+		buff[len - 1] = 0;
+		return;
+	}
+
+	p = buff;
+	if (v < 0) {
+		*p++ = '-';
+		v = -v;
+	}
+	n = ShortestDigits(v, digits, &k);
+	x = k - 1; /* exponent of the first digit */
+	if (x < -4 || x >= ((n > 10) ? n : 10)) {
+		*p++ = digits[0];
+		if (n > 1) {
+			*p++ = '.';
+			memcpy(p, digits + 1, n - 1);
+			p += n - 1;
+		}
+		*p++ = 'e';
+		*p++ = (x < 0) ? '-' : '+';
+		if (x < 0)
+			x = -x;
+		if (x < 10)
+			*p++ = '0';
+		p += snprintf(p, 8, "%d", x);
+	}
+	else if (x < 0) {
+		*p++ = '0';
+		*p++ = '.';
+		for (i = -1; i > x; i--)
+			*p++ = '0';
+		memcpy(p, digits, n);
+		p += n;
+	}
+	else {
+		for (i = 0; i <= x || i < n; i++) {
+			if (i == x + 1)
+				*p++ = '.';
+			*p++ = (i < n) ? digits[i] : '0';
+		}
+	}
+	*p = '\0';
+}
+
+static void rPrint(object a)
+/* print any object in default numeric format */
+{
+	int length;
+	int multi_line;
+	object_ptr elem;
+	char sbuff[NUM_SIZE];
+
+	if (print_lines == 0)
+		return;
+
+	if (IS_ATOM(a)) {
+		if (IS_ATOM_INT(a)) {
+			snprintf(sbuff, NUM_SIZE, "%" PRIdPTR, a);
+			sbuff[NUM_SIZE-1] = 0; // ensure NULL
+			screen_output(print_file, sbuff);
+			print_chars += strlen(sbuff);
+			if (show_ascii && a >= ' ' &&
+#ifdef __unix
+				a <= 126)  // DEL is a problem with ANSI code display
+#else
+				a <= 127)
+#endif
+				print_chars += show_ascii_char(print_file, a);
+		}
+                else if (a == NOVALUE) {
+                        screen_output(print_file, "NOVALUE" );
+                        print_chars += strlen("NOVALUE");
+                }
+		else {
+			FormatAtom(sbuff, NUM_SIZE, DBL_PTR(a)->dbl);
+			screen_output(print_file, sbuff);
+			print_chars += strlen(sbuff);
+		}
+	}
+	else {
 		/* a is a SEQUENCE */
 		a = (object)SEQ_PTR(a);
 		cut_line(1);
@@ -4213,132 +5798,834 @@ void StdPrint(object fn, object a, int new_lines)
 		screen_output(print_file, "\n");
 }
 
-void EPuts(object file_no, object obj)
-/* print out a string of characters */
+object ESprint(object a)
+/* the text print() would show for a, as a sequence */
 {
-	object_ptr elem;
-	char *out_ptr;
-	long n;
-	int c, size;
-	long len;
-	IFILE f;
+	object result;
 
-	if (file_no == last_w_file_no)
-		f = last_w_file_ptr;
-	else {
-		f = which_file(file_no, EF_WRITE);
-		if (IS_ATOM_INT(file_no))
-			last_w_file_no = file_no;
+	print_lines = MAX_LONG;
+	print_width = MAX_LONG;
+	print_file = (IFILE)DOING_SPRINTF;
+	print_chars = 0;
+	print_start = 0;
+	print_level = 0;
+	print_pretty = FALSE;
+	show_ascii = FALSE;
+	rPrint(a);
+	if (collect == NULL)
+		return NewString("");
+	result = NewString(collect);
+	EFree(collect);
+	collect = NULL;
+	return result;
+}
+
+/* get() and value(): read back the text of an object. This is the grammar
+   of std/get.e with the same status codes, counts and quirks, and it takes
+   the same characters from a file, so where() agrees afterwards. Numbers
+   are converted with strtod(), so decimals are rounded correctly. */
+
+#define GET_SUCCESS 0
+#define GET_EOF -1
+#define GET_FAIL 1
+#define GET_NOTHING -2
+#define GET_IGNORE GET_NOTHING   /* a comment was read */
+
+#define GET_BLANK(c) ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r')
+#define GET_DIGIT(c) ((c) >= '0' && (c) <= '9')
+
+static s1_ptr get_str;      /* string read by value(), NULL for get() */
+static IFILE get_file;      /* file read by get() */
+static int get_keyb;        /* get() is reading the keyboard */
+static intptr_t get_next;   /* string_next of get.e */
+static intptr_t get_c;      /* the current character, "live" as in get.e */
+
+/* elements of the sequences and strings being read, innermost last */
+static object_ptr get_stack = NULL;
+static intptr_t get_top = 0;
+static intptr_t get_stack_size = 0;
+
+/* text of the number being read */
+static char *get_num = NULL;
+static int get_num_len = 0;
+static int get_num_size = 0;
+
+static intptr_t get_elem(intptr_t i)
+/* character i of the string */
+{
+	object c = get_str->base[i];
+
+	if (!IS_ATOM_INT(c))
+		RTFatal("value() expects a sequence of characters");
+	return c;
+}
+
+static void get_ch()
+/* the next character, or GET_EOF */
+{
+	if (get_str != NULL) {
+		if (get_next <= get_str->length)
+			get_c = get_elem(get_next++);
 		else
-			last_w_file_no = NOVALUE;
-		last_w_file_ptr = f;
+			get_c = GET_EOF;
 	}
-	if (IS_ATOM(obj)) {
-		c = Char(obj);
-		if (f == stdout || f == stderr || f == NULL) {
-			/* might be going to screen, won't be binary mode */
-			TempBuff[0] = c;
-			TempBuff[1] = '\0';
-			screen_output(f, TempBuff);
+	else {
+		get_c = get_keyb ? getKBchar() : getc(get_file);
+		if (get_c == EOF) {
+			get_c = GET_EOF;
+			get_next++;
+		}
+	}
+}
+
+static void get_skip_blanks()
+{
+	while (GET_BLANK(get_c))
+		get_ch();
+}
+
+static void get_push(object x)
+{
+	if (get_top == get_stack_size) {
+		if (get_stack == NULL) {
+			get_stack_size = 256;
+			get_stack = (object_ptr)EMalloc(get_stack_size * sizeof(object));
 		}
 		else {
-			/* might be binary mode, must allow for 0's */
-			if (current_screen != MAIN_SCREEN && might_go_screen(file_no))
-				MainScreen();
-			iputc(c, f);
+			get_stack_size *= 2;
+			get_stack = (object_ptr)ERealloc((char *)get_stack,
+			                                 get_stack_size * sizeof(object));
 		}
 	}
-	else {
-		obj = (object)SEQ_PTR(obj);
-		elem = ((s1_ptr)obj)->base;
-		len = ((s1_ptr)obj)->length;
-		while (len > 0) {
-			n = len;
-			if (n >= TEMP_SIZE)
-				n = TEMP_SIZE - 1; /* need space for 0 */
-			len = len - n;
-			out_ptr = TempBuff;
-			size = n;
-			do {
-				elem++;
-				*out_ptr++ = Char(*elem);
-			} while (--n > 0);
-			if (f == stdout || f == stderr || f == NULL) {
-				*out_ptr = '\0';
-				screen_output(f, TempBuff);
-			}
-			else {
-				if (current_screen != MAIN_SCREEN && might_go_screen(file_no))
-					MainScreen();
-				iwrite(TempBuff, size, 1, f);  /* allow for 0's */
-			}
+	get_stack[get_top++] = x;
+}
+
+static object get_pop(intptr_t start)
+/* the elements pushed since start, as a sequence */
+{
+	s1_ptr s;
+
+	s = NewS1(get_top - start);
+	memcpy(s->base + 1, get_stack + start, (get_top - start) * sizeof(object));
+	get_top = start;
+	return MAKE_SEQ(s);
+}
+
+static void get_drop(intptr_t start)
+/* forget the elements pushed since start */
+{
+	while (get_top > start) {
+		get_top--;
+		DeRef(get_stack[get_top]);
+	}
+}
+
+static void get_num_add(int c)
+{
+	if (get_num_len == get_num_size) {
+		if (get_num == NULL) {
+			get_num_size = 64;
+			get_num = EMalloc(get_num_size);
+		}
+		else {
+			get_num_size *= 2;
+			get_num = ERealloc(get_num, get_num_size);
 		}
 	}
+	get_num[get_num_len++] = (char)c;
 }
 
+static intptr_t get_escape(intptr_t c)
+/* the character escaped by \c, or GET_FAIL */
+{
+	switch (c) {
+		case 'n':  return '\n';
+		case '\'': return '\'';
+		case '"':  return '"';
+		case 't':  return '\t';
+		case '\\': return '\\';
+		case 'r':  return '\r';
+	}
+	return GET_FAIL;
+}
 
-static object_ptr FormatItem(f, cstring, f_elem, f_last, v_elem)
-/* print one format item from printf */
-IFILE f;
-char *cstring;
-object_ptr f_elem;
-object_ptr f_last;
-object_ptr v_elem;
+static int get_qchar(object *value)
+/* a single-quoted character */
 {
-	int flen, sbuff_len=0;
-	char c;
-	intptr_t dval;
-	uintptr_t uval;
-	eudouble gval = (eudouble)0;
-	char *sval;
-	char *sbuff;
-	int slength;
-	char quick_alloc1[LOCAL_SPACE];
-	int free_sv;
-	int free_sb;
+	intptr_t c;
 
-	c = '%';
-	flen = 0;
-	do {
-		cstring[flen++] = c;
-		if (++f_elem > f_last) {
-			cstring[flen] = '\0';
-			RTFatal("format specifier is incomplete (%s)", cstring);
-		}
-		c = Char(*f_elem);
-	} while (IsDigit(c) || c == '.' || c == '-' || c == '+');
+	get_ch();
+	c = get_c;
+	if (get_c == '\\') {
+		get_ch();
+		c = get_escape(get_c);
+		if (c == GET_FAIL)
+			return GET_FAIL;
+	}
+	else if (get_c == '\'')
+		return GET_FAIL;
+	get_ch();
+	if (get_c != '\'')
+		return GET_FAIL;
+	get_ch();
+	*value = MAKE_INT(c);
+	return GET_SUCCESS;
+}
 
-	free_sb = FALSE;
-	if (c == 's') {
-		int len_used;
-		cstring[flen++] = c;
-		cstring[flen] = '\0';
-		free_sv = FALSE;
-		if (IS_SEQUENCE(*v_elem)) {
-			slength = (SEQ_PTR(*v_elem))->length + 1;
-			if (slength > LOCAL_SPACE) {
-				sval = EMalloc(slength);
-				free_sv = TRUE;
-				len_used = slength;
+static int get_heredoc(char *terminator, int len, object *value)
+/* raw text up to terminator; unlike the other readers this leaves the
+   last character of the terminator as the current one */
+{
+	intptr_t start = get_top;
+	int i;
+
+	while (TRUE) {
+		get_ch();
+		get_push(get_c);
+		if (get_top - start >= len) {
+			for (i = 0; i < len; i++) {
+				if (get_stack[get_top - len + i] != terminator[i])
+					break;
 			}
-			else {
-				sval = quick_alloc1;
-				len_used = LOCAL_SPACE;
+			if (i == len) {
+				get_top -= len;
+				*value = get_pop(start);
+				return GET_SUCCESS;
 			}
-			MakeCString(sval, *v_elem, len_used);
-		}
-		else {
-			slength = 4L;
-			sval = quick_alloc1;
-			sval[0] = Char(*v_elem);
-			sval[1] = '\0';
 		}
-		if (slength + flen > TEMP_SIZE) {
-			sbuff_len = slength + flen;
-			sbuff = EMalloc(sbuff_len);
-			free_sb = TRUE;
+		if (get_c == GET_EOF) {
+			get_top = start;
+			return GET_FAIL;
 		}
-		else {
+	}
+}
+
+static int get_string(object *value)
+/* a double-quoted string, or a """ heredoc */
+{
+	intptr_t start = get_top;
+
+	while (TRUE) {
+		get_ch();
+		if (get_c == GET_EOF || get_c == '\n') {
+			get_top = start;
+			return GET_FAIL;
+		}
+		else if (get_c == '"') {
+			get_ch();
+			if (get_top == start && get_c == '"')
+				return get_heredoc("\"\"\"", 3, value);
+			*value = get_pop(start);
+			return GET_SUCCESS;
+		}
+		else if (get_c == '\\') {
+			get_ch();
+			get_c = get_escape(get_c);
+			if (get_c == GET_FAIL) {
+				get_top = start;
+				return GET_FAIL;
+			}
+		}
+		get_push(get_c);
+	}
+}
+
+static int get_comment()
+/* the rest of a -- comment */
+{
+	intptr_t i;
+
+	if (get_str == NULL) {
+		while (get_c != '\n' && get_c != '\r' && get_c != GET_EOF)
+			get_ch();
+		get_ch();
+		return get_c == GET_EOF ? GET_EOF : GET_IGNORE;
+	}
+	/* in a string the line end stays the current character */
+	for (i = get_next; i <= get_str->length; i++) {
+		get_c = get_elem(i);
+		if (get_c == '\n' || get_c == '\r') {
+			get_next = i + 1;
+			return GET_IGNORE;
+		}
+	}
+	return GET_EOF;
+}
+
+static int get_number(object *value)
+/* a number or a comment */
+{
+	int sign = 1, fraction = FALSE;
+	intptr_t ndigits = 0, d, i, n;
+	eudouble mantissa;
+
+	get_num_len = 0;
+	if (get_c == '-') {
+		sign = -1;
+		get_ch();
+		if (get_c == '-')
+			return get_comment();
+		get_num_add('-');
+	}
+	else if (get_c == '+')
+		get_ch();
+
+	if (get_c == '#') {
+		mantissa = 0.0;
+		while (TRUE) {
+			get_ch();
+			if (GET_DIGIT(get_c))
+				d = get_c - '0';
+			else if (get_c >= 'A' && get_c <= 'F')
+				d = get_c - 'A' + 10;
+			else
+				break;
+			ndigits++;
+			mantissa = mantissa * 16 + d;
+		}
+		if (ndigits == 0)
+			return GET_FAIL;
+		if (mantissa <= MAXINT_DBL)
+			*value = MAKE_INT(sign * (intptr_t)mantissa);
+		else
+			*value = NewDouble(sign * mantissa);
+		return GET_SUCCESS;
+	}
+
+	while (GET_DIGIT(get_c)) {
+		ndigits++;
+		get_num_add(get_c);
+		get_ch();
+	}
+	if (get_c == '.') {
+		get_num_add('.');
+		get_ch();
+		while (GET_DIGIT(get_c)) {
+			ndigits++;
+			if (get_c != '0')
+				fraction = TRUE;
+			get_num_add(get_c);
+			get_ch();
+		}
+	}
+	if (ndigits == 0)
+		return GET_FAIL;
+
+	if (get_c == 'e' || get_c == 'E') {
+		get_num_add('e');
+		get_ch();
+		if (get_c == '-' || get_c == '+') {
+			get_num_add(get_c);
+			get_ch();
+		}
+		if (!GET_DIGIT(get_c))
+			return GET_FAIL; /* no exponent */
+		while (GET_DIGIT(get_c)) {
+			get_num_add(get_c);
+			get_ch();
+		}
+		fraction = TRUE;
+	}
+
+	if (!fraction) {
+		/* a whole number, an integer when it fits as in get.e */
+		n = 0;
+		for (i = (sign < 0); i < get_num_len && get_num[i] != '.'; i++) {
+			d = get_num[i] - '0';
+			if (n > (MAXINT - d) / 10) {
+				n = -1;
+				break;
+			}
+			n = n * 10 + d;
+		}
+		if (n >= 0) {
+			*value = MAKE_INT(sign * n);
+			return GET_SUCCESS;
+		}
+	}
+	get_num_add('\0');
+	*value = NewDouble((eudouble)EUSTRTOD(get_num, NULL));
+	return GET_SUCCESS;
+}
+
+static int get_object(object *value, int long_top);
+
+static int get_short(object *value)
+/* Get() of get.e: the current character is live at entry and exit */
+{
+	get_skip_blanks();
+	if (get_c == GET_EOF)
+		return GET_EOF;
+	return get_object(value, FALSE);
+}
+
+static int get_object(object *value, int long_top)
+/* the rest of Get(), or of Get2() when long_top is set, from the first
+   character that isn't white space */
+{
+	int status;
+	intptr_t start;
+	object e;
+
+	while (TRUE) {
+		if (GET_DIGIT(get_c) || get_c == '-' || get_c == '+' ||
+		    get_c == '.' || get_c == '#') {
+			status = get_number(value);
+			if (status != GET_IGNORE)
+				return status;
+			if (long_top) {
+				get_ch();
+				if (get_c == GET_EOF)
+					return GET_NOTHING;
+			}
+			else {
+				get_skip_blanks();
+				if (get_c == GET_EOF || get_c == '}')
+					return GET_NOTHING; /* just a comment */
+			}
+		}
+		else if (get_c == '{') {
+			start = get_top;
+			get_ch();
+			get_skip_blanks();
+			if (get_c == '}') {
+				get_ch();
+				*value = get_pop(start);
+				return GET_SUCCESS;
+			}
+			while (TRUE) {
+				/* comments and an element */
+				while (TRUE) {
+					status = get_short(&e);
+					if (status == GET_SUCCESS) {
+						get_push(e);
+						break;
+					}
+					if (status != GET_IGNORE) {
+						get_drop(start);
+						return status;
+					}
+					if (get_c == '}') {
+						get_ch();
+						*value = get_pop(start);
+						return GET_SUCCESS;
+					}
+				}
+				/* comments after the element */
+				while (TRUE) {
+					get_skip_blanks();
+					if (get_c == '}') {
+						get_ch();
+						*value = get_pop(start);
+						return GET_SUCCESS;
+					}
+					if (get_c != '-')
+						break;
+					status = get_number(&e);
+					if (status != GET_IGNORE) {
+						if (status == GET_SUCCESS)
+							DeRef(e);
+						get_drop(start);
+						return GET_FAIL;
+					}
+				}
+				if (get_c != ',') {
+					get_drop(start);
+					return GET_FAIL;
+				}
+				get_ch();
+			}
+		}
+		else if (get_c == '"')
+			return get_string(value);
+		else if (get_c == '`')
+			return get_heredoc("`", 1, value);
+		else if (get_c == '\'')
+			return get_qchar(value);
+		else
+			return GET_FAIL;
+	}
+}
+
+object EGetValue(object x)
+/* machine_func(M_GET_VALUE, {target, start_point, long_answer}):
+   get() when target is a file number, value() when it is a string.
+   Returns {status, value} or {status, value, characters read,
+   leading white space}. */
+{
+	s1_ptr args, result;
+	object target, value;
+	intptr_t offset, count, lead;
+	int status, long_answer;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 3)
+		RTFatal("get value expects {target, start_point, long_answer}");
+	args = SEQ_PTR(x);
+	target = args->base[1];
+	long_answer = args->base[3] != ATOM_0;
+
+	if (IS_SEQUENCE(target)) {
+		if (!IS_ATOM_INT(args->base[2]) || args->base[2] < 1)
+			RTFatal("value() start_point must be at least 1");
+		get_str = SEQ_PTR(target);
+		get_next = args->base[2];
+	}
+	else {
+		if (target == last_r_file_no)
+			get_file = last_r_file_ptr;
+		else {
+			get_file = which_file(target, EF_READ);
+			if (IS_ATOM_INT(target))
+				last_r_file_no = target;
+			else
+				last_r_file_no = NOVALUE;
+			last_r_file_ptr = get_file;
+		}
+		if (current_screen != MAIN_SCREEN && might_go_screen(last_r_file_no))
+			MainScreen();
+#ifdef _WIN32
+		if (get_file == stdin)
+			show_console();
+#endif
+		get_keyb = get_file == stdin && in_from_keyb;
+		get_str = NULL;
+		get_next = 1;
+	}
+
+	get_top = 0;
+	value = ATOM_0;
+	if (long_answer) {
+		/* Get2() of get.e */
+		offset = get_next - 1;
+		get_ch();
+		get_skip_blanks();
+		if (get_c == GET_EOF) {
+			status = GET_EOF;
+			count = get_next - 1 - offset;
+			lead = get_next - 1;
+		}
+		else {
+			lead = get_next - 2 - offset;
+			status = get_object(&value, TRUE);
+			count = get_next - 1 - offset - (get_c != GET_EOF);
+		}
+	}
+	else {
+		get_ch();
+		status = get_short(&value);
+	}
+
+	/* don't hold on to the room a big sequence needed */
+	if (get_stack_size > 4096) {
+		EFree((char *)get_stack);
+		get_stack = NULL;
+		get_stack_size = 0;
+	}
+
+	result = NewS1(long_answer ? 4 : 2);
+	result->base[1] = MAKE_INT(status);
+	result->base[2] = value;
+	if (long_answer) {
+		result->base[3] = MAKE_INT(count);
+		result->base[4] = MAKE_INT(lead);
+	}
+	return MAKE_SEQ(result);
+}
+
+void EPuts(object file_no, object obj)
+/* print out a string of characters */
+{
+	object_ptr elem;
+	char *out_ptr;
+	long n;
+	int c, size;
+	long len;
+	IFILE f;
+
+	if (file_no == last_w_file_no)
+		f = last_w_file_ptr;
+	else {
+		f = which_file(file_no, EF_WRITE);
+		if (IS_ATOM_INT(file_no))
+			last_w_file_no = file_no;
+		else
+			last_w_file_no = NOVALUE;
+		last_w_file_ptr = f;
+	}
+	if (IS_ATOM(obj)) {
+		c = Char(obj);
+		if (f == stdout || f == stderr || f == NULL) {
+			/* might be going to screen, won't be binary mode */
+			TempBuff[0] = c;
+			TempBuff[1] = '\0';
+			screen_output(f, TempBuff);
+		}
+		else {
+			/* might be binary mode, must allow for 0's */
+			if (current_screen != MAIN_SCREEN && might_go_screen(file_no))
+				MainScreen();
+			iputc(c, f);
+		}
+	}
+	else {
+		obj = (object)SEQ_PTR(obj);
+		elem = ((s1_ptr)obj)->base;
+		len = ((s1_ptr)obj)->length;
+		while (len > 0) {
+			n = len;
+			if (n >= TEMP_SIZE)
+				n = TEMP_SIZE - 1; /* need space for 0 */
+			len = len - n;
+			out_ptr = TempBuff;
+			size = n;
+			do {
+				elem++;
+				*out_ptr++ = Char(*elem);
+			} while (--n > 0);
+			if (f == stdout || f == stderr || f == NULL) {
+				*out_ptr = '\0';
+				screen_output(f, TempBuff);
+			}
+			else {
+				if (current_screen != MAIN_SCREEN && might_go_screen(file_no))
+					MainScreen();
+				iwrite(TempBuff, size, 1, f);  /* allow for 0's */
+			}
+		}
+	}
+}
+
+
+/* printf() and sprintf() formats are split once into items of text and
+   format specifiers, and kept in a small cache keyed by the format
+   sequence. The cache holds a reference to each format, so a cached
+   format can't be changed in place or freed and its memory reused. */
+
+#define FMT_TEXT 0  /* characters printed as they are */
+#define FMT_SPEC 1  /* % with flags, width and precision, then conv */
+
+struct fmt_item {
+	char kind;
+	char conv;  /* conversion character, or 0 if the specifier is incomplete */
+	int start;  /* the text or specifier, null-terminated, in pool */
+	int len;
+};
+
+struct fmt {
+	object format;
+	int nitems;
+	struct fmt_item *items;
+	char *pool;
+};
+
+#define FMT_CACHE_SIZE 32 /* a power of 2 */
+
+static struct fmt *fmt_cache[FMT_CACHE_SIZE];
+
+static struct fmt *ParseFormat(s1_ptr format)
+/* split a non-empty format into its items */
+{
+	object_ptr f_elem, f_last;
+	struct fmt *fmt;
+	struct fmt_item *item;
+	char *pool;
+	char c;
+	int p, in_text, truncated;
+	intptr_t flen;
+
+	flen = format->length;
+	fmt = (struct fmt *)EMalloc(sizeof(struct fmt) +
+		flen * sizeof(struct fmt_item) + 2 * flen + 1);
+	fmt->items = (struct fmt_item *)(fmt + 1);
+	fmt->pool = pool = (char *)(fmt->items + flen);
+	item = fmt->items - 1;
+	p = 0;
+	in_text = FALSE;
+	truncated = FALSE;
+
+	f_elem = format->base + 1;
+	f_last = format->base + flen;
+	while (f_elem <= f_last) {
+		c = Char(*f_elem);
+		if (c == '%' && !(f_elem < f_last && Char(*(f_elem + 1)) == '%')) {
+			if (in_text) {
+				item->len = p - item->start;
+				pool[p++] = '\0';
+				in_text = FALSE;
+			}
+			item++;
+			item->kind = FMT_SPEC;
+			item->start = p;
+			item->conv = 0;
+			do {
+				pool[p++] = c;
+				if (++f_elem > f_last)
+					break;
+				c = Char(*f_elem);
+			} while (IsDigit(c) || c == '.' || c == '-' || c == '+');
+			item->len = p - item->start;
+			pool[p++] = '\0';
+			if (f_elem > f_last)
+				break; /* incomplete, an error when it is printed */
+			item->conv = c;
+		}
+		else {
+			if (c == '%')
+				f_elem++; /* %% */
+			if (!in_text) {
+				item++;
+				item->kind = FMT_TEXT;
+				item->start = p;
+				in_text = TRUE;
+				truncated = FALSE;
+			}
+			/* text is printed as C strings, which end at a 0 */
+			if (c == '\0')
+				truncated = TRUE;
+			else if (!truncated)
+				pool[p++] = c;
+		}
+		f_elem++;
+	}
+	if (in_text) {
+		item->len = p - item->start;
+		pool[p++] = '\0';
+	}
+	fmt->nitems = item + 1 - fmt->items;
+	return fmt;
+}
+
+static struct fmt *GetFormat(object format_obj)
+/* the items of a non-empty format sequence, from the cache if possible.
+   A format that isn't cached comes back with fmt->format == NOVALUE,
+   and the caller must EFree() it. */
+{
+	struct fmt *fmt;
+	int i;
+
+	i = (int)((format_obj ^ (format_obj >> 7)) & (FMT_CACHE_SIZE - 1));
+	fmt = fmt_cache[i];
+	if (fmt != NULL && fmt->format == format_obj)
+		return fmt;
+
+	fmt = ParseFormat(SEQ_PTR(format_obj));
+	if (in_arena(SEQ_PTR(format_obj)) || SEQ_PTR(format_obj)->cleanup != 0) {
+		/* a cache entry would keep the format's arena chunk alive,
+		   or put off its delete_routine() until it is evicted;
+		   the caller frees an uncached fmt */
+		fmt->format = NOVALUE;
+		return fmt;
+	}
+
+	if (fmt_cache[i] != NULL) {
+		DeRefDS(fmt_cache[i]->format);
+		EFree((char *)fmt_cache[i]);
+	}
+	RefDS(format_obj);
+	fmt->format = format_obj;
+	fmt_cache[i] = fmt;
+	return fmt;
+}
+
+static char *IntToString(intptr_t value, char *end)
+/* write value in decimal ending just before end, and return its start */
+{
+	uintptr_t u;
+
+	*--end = '\0';
+	u = (value < 0) ? (uintptr_t)0 - (uintptr_t)value : (uintptr_t)value;
+	do {
+		*--end = '0' + (char)(u % 10);
+		u /= 10;
+	} while (u != 0);
+	if (value < 0)
+		*--end = '-';
+	return end;
+}
+
+static void FormatItem(IFILE f, char *spec, int flen, char c, object_ptr v_elem)
+/* print one value with the format specifier spec, flen characters of %,
+   flags, width and precision, and conversion character c */
+{
+	int sbuff_len=0;
+	intptr_t dval;
+	uintptr_t uval;
+	eudouble gval = (eudouble)0;
+	char *sval;
+	char *sbuff;
+	char *cstring;
+	int slength;
+	char quick_alloc1[LOCAL_SPACE];
+	char quick_alloc2[LOCAL_SPACE];
+	char nbuff[NUM_SIZE];
+	int free_sv;
+	int free_sb;
+	int free_cs;
+
+	if (flen == 1) {
+		/* plain %d or %s need no C formatting */
+		if (c == 'd' && IS_ATOM_INT(*v_elem)) {
+			screen_output(f, IntToString(INT_VAL(*v_elem), nbuff + NUM_SIZE));
+			return;
+		}
+		if (c == 's' && IS_SEQUENCE(*v_elem)) {
+			slength = (SEQ_PTR(*v_elem))->length + 1;
+			if (slength > LOCAL_SPACE)
+				sval = EMalloc(slength);
+			else
+				sval = quick_alloc1;
+			MakeCString(sval, *v_elem, slength);
+			screen_output(f, sval);
+			if (sval != quick_alloc1)
+				EFree(sval);
+			return;
+		}
+	}
+
+	/* room for the flags, a length modifier, conversion and 0 */
+	if (flen + 6 > LOCAL_SPACE) {
+		cstring = EMalloc(flen + 6);
+		free_cs = TRUE;
+	}
+	else {
+		cstring = quick_alloc2;
+		free_cs = FALSE;
+	}
+	memcpy(cstring, spec, flen + 1);
+	if (c == '\0')
+		RTFatal("format specifier is incomplete (%s)", cstring);
+
+	free_sb = FALSE;
+	if (c == 's') {
+		int len_used;
+		cstring[flen++] = c;
+		cstring[flen] = '\0';
+		free_sv = FALSE;
+		if (IS_SEQUENCE(*v_elem)) {
+			slength = (SEQ_PTR(*v_elem))->length + 1;
+			if (slength > LOCAL_SPACE) {
+				sval = EMalloc(slength);
+				free_sv = TRUE;
+				len_used = slength;
+			}
+			else {
+				sval = quick_alloc1;
+				len_used = LOCAL_SPACE;
+			}
+			MakeCString(sval, *v_elem, len_used);
+		}
+		else {
+			slength = 4L;
+			sval = quick_alloc1;
+			sval[0] = Char(*v_elem);
+			sval[1] = '\0';
+		}
+		if (slength + flen > TEMP_SIZE) {
+			sbuff_len = slength + flen;
+			sbuff = EMalloc(sbuff_len);
+			free_sb = TRUE;
+		}
+		else {
 			sbuff = TempBuff;
 			sbuff_len = TEMP_SIZE;
 		}
@@ -4432,7 +6719,8 @@ object_ptr v_elem;
 	}
 	if (free_sb)
 		EFree(sbuff);
-	return(f_elem);
+	if (free_cs)
+		EFree(cstring);
 }
 
 
@@ -4440,18 +6728,12 @@ object EPrintf(object file_no, object format_obj, object values)
 /* formatted print */
 /* file_no could be DOING_SPRINTF (for sprintf) */
 {
-	object_ptr f_elem, f_last;
-	char c; /* avoid peep bug - no register decl */
 	object_ptr v_elem, v_last = 0;
-	char *cstring;
-	char quick_alloc[LOCAL_SPACE]; // don't use TempBuff - FormatItem uses it
-	int free_cs;
 	char out_string[LOCAL_SPACE];
-	int flen;
-	int s;
 	IFILE f;
 	object result;
-	s1_ptr format;
+	struct fmt *fmt;
+	struct fmt_item *item, *last;
 
 	if (file_no == DOING_SPRINTF) {
 		f = (IFILE )DOING_SPRINTF;
@@ -4468,89 +6750,48 @@ object EPrintf(object file_no, object format_obj, object values)
 			last_w_file_ptr = f;
 		}
 	}
-	free_cs = FALSE;
 	buffer_screen();
 	if (IS_ATOM(format_obj)) {
 		out_string[0] = doChar(format_obj);
 		out_string[1] = '\0';
 		screen_output(f, out_string);
 	}
+	else if (SEQ_PTR(format_obj)->length == 0) {
+		screen_output(f, "");
+	}
 	else {
-		format = SEQ_PTR(format_obj);
-		flen = format->length;
-		if (flen == 0) {
-			screen_output(f, "");
-		}
+		fmt = GetFormat(format_obj);
+		if (IS_ATOM(values))
+			v_elem = &values;
 		else {
-			f_elem = format->base;
-			f_last = f_elem + flen;
-			f_elem++;
-			if (flen > LOCAL_SPACE) {
-				cstring = EMalloc(flen + 1);
-				free_cs = TRUE;
+			v_elem = SEQ_PTR(values)->base;
+			v_last = v_elem + SEQ_PTR(values)->length;
+			v_elem++;
+		}
+		last = fmt->items + fmt->nitems;
+		for (item = fmt->items; item < last; item++) {
+			if (item->kind == FMT_TEXT) {
+				screen_output(f, fmt->pool + item->start);
 			}
-			else
-				cstring = quick_alloc;
-			if (IS_ATOM(values))
-				v_elem = &values;
 			else {
-				v_elem = SEQ_PTR(values)->base;
-				v_last = v_elem + SEQ_PTR(values)->length;
-				v_elem++;
-			}
-			out_string[0] = '\0';
-			s = 0;
-			while (f_elem <= f_last) {
-				c = Char((object)*f_elem);
-				if (c == '%') {
-					if (f_elem < f_last && Char((object)*(f_elem + 1)) == '%') {
-						/* %% */
-						if (s >= LOCAL_SPACE-1) {
-							out_string[s] = '\0';
-							screen_output(f, out_string);
-							s = 0;
-						}
-						out_string[s++] = '%';
-						f_elem++;
-					}
-					else {
-						if (IS_SEQUENCE(values) && v_elem > v_last) {
-							if (file_no == DOING_SPRINTF)
-								RTFatal("not enough values to print in sprintf()");
-							else
-								RTFatal("not enough values to print in printf()");
-						}
-						if (s != 0) {
-							out_string[s] = '\0';
-							screen_output(f, out_string);
-							s = 0;
-						}
-						f_elem = FormatItem(f, cstring, f_elem, f_last, v_elem);
-						if (IS_SEQUENCE(values))
-							v_elem++;
-					}
-				}
-				else {
-					if (s >= LOCAL_SPACE-1) {
-						out_string[s] = '\0';
-						screen_output(f, out_string);
-						s = 0;
-					}
-					out_string[s++] = c;
+				if (IS_SEQUENCE(values) && v_elem > v_last) {
+					if (file_no == DOING_SPRINTF)
+						RTFatal("not enough values to print in sprintf()");
+					else
+						RTFatal("not enough values to print in printf()");
 				}
-				f_elem++;
-			} /* end while */
-
-			if (s != 0) {
-				out_string[s] = '\0';
-				screen_output(f, out_string);
+				FormatItem(f, fmt->pool + item->start, item->len, item->conv, v_elem);
+				if (IS_SEQUENCE(values))
+					v_elem++;
 			}
-			if (free_cs)
-				EFree(cstring);
 		}
+		if (fmt->format == NOVALUE)
+			EFree((char *)fmt);
 	}
 	flush_screen();
 	if (file_no == DOING_SPRINTF) {
+		if (collect == NULL)
+			return NewString("");
 		result = NewString(collect);
 		EFree(collect);
 		collect = NULL;
@@ -4666,6 +6907,69 @@ static void RTInternal(char *msg, ...)
 
 void *xstdin;
 
+static uint32_t name_hash(char *name, uint32_t seed)
+/* FNV-1a hash of name started from seed, as name_hash() in c_decl.e */
+{
+	uint32_t h = seed ? seed : 2166136261u;
+
+	while (*name) {
+		h ^= (unsigned char)*name++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static int hash_slot(struct name_hash *table, char *name)
+/* index of the first entry that may be called name, or -1 */
+{
+	int d;
+
+	if (table->size == 0)
+		return -1;
+	d = table->disp[name_hash(name, 0) % table->size];
+	if (d < 0)
+		return table->first[-d - 1];
+	return table->first[name_hash(name, d) % table->size];
+}
+
+static int next_routine(int i, char *name)
+/* index in rt00 of the next routine after i called name, -1 if none.
+   i = -1 gives the first one. */
+{
+	if (rt03 != NULL) {
+		if (i >= 0)
+			return rt03->next[i];
+		i = hash_slot(rt03, name);
+		if (i >= 0 && strcmp(name, rt00[i].name) != 0)
+			i = -1;
+		return i;
+	}
+	for (i++; rt00[i].seq_num <= 999999998; i++) {
+		if (strcmp(name, rt00[i].name) == 0)
+			return i;
+	}
+	return -1;
+}
+
+static int next_namespace(int i, char *name)
+/* index in rt01 of the next namespace after i called name, -1 if none.
+   i = -1 gives the first one. */
+{
+	if (rt04 != NULL) {
+		if (i >= 0)
+			return rt04->next[i];
+		i = hash_slot(rt04, name);
+		if (i >= 0 && strcmp(name, rt01[i].name) != 0)
+			i = -1;
+		return i;
+	}
+	for (i++; rt01[i].seq_num <= 999999998; i++) {
+		if (strcmp(name, rt01[i].name) == 0)
+			return i;
+	}
+	return -1;
+}
+
 int CRoutineId(int seq_num, int current_file_no, object name)
 /* Routine_id for compiled code.
    (Similar to RTLookup() for interpreter, but here we only find routines,
@@ -4694,7 +6998,7 @@ int CRoutineId(int seq_num, int current_file_no, object name)
 	MakeCString(routine_string, name, TEMP_SIZE);
 
 	colon = strchr(routine_string, ':');
-	seq_num = 999999998; // look through the whole list
+	// the whole list is searched, whatever seq_num is
 	if (colon != NULL) {
 		/* look up "ns : name" */
 
@@ -4719,17 +7023,14 @@ int CRoutineId(int seq_num, int current_file_no, object name)
 		if( strcmp( ns, "eu") == 0 )
 			// Predefined routines don't have routine_ids
 			return ATOM_M1;
-		i = 0;
-		while (TRUE) {
-			if (rt01[i].seq_num > seq_num){
-				return ATOM_M1; // ignore symbols defined after this point
+		for (i = next_namespace(-1, ns); ; i = next_namespace(i, ns)) {
+			if (i < 0) {
+				return ATOM_M1;
 			}
-			if (rt02[current_file_no][rt01[i].file_num] & DIRECT_OR_PUBLIC_INCLUDE &&
-				strcmp(ns, rt01[i].name) == 0) {
+			if (rt02[current_file_no][rt01[i].file_num] & DIRECT_OR_PUBLIC_INCLUDE) {
 				ns_file = rt01[i].ns_num;
 				break;
 			}
-			i++;
 		}
 
 		/* step 2: look up global symbol in the chosen namespace */
@@ -4739,10 +7040,8 @@ int CRoutineId(int seq_num, int current_file_no, object name)
 		while (*simple_name == ' ' || *simple_name == '\t')
 			simple_name++;
 
-		i = 0;
-
-		while (rt00[i].seq_num <= seq_num) {
-			if( (( rt00[i].scope == S_PUBLIC
+		for (i = next_routine(-1, simple_name); i >= 0; i = next_routine(i, simple_name)) {
+			if( ( rt00[i].scope == S_PUBLIC
 					&& ( (rt00[i].file_num == ns_file && rt02[current_file_no][ns_file] & DIRECT_OR_PUBLIC_INCLUDE ) ||
 						(rt02[ns_file][rt00[i].file_num] & PUBLIC_INCLUDE &&
 						 rt02[current_file_no][ns_file] & DIRECT_OR_PUBLIC_INCLUDE)))
@@ -4754,11 +7053,9 @@ int CRoutineId(int seq_num, int current_file_no, object name)
 					&& ( (rt00[i].file_num == ns_file  && rt02[current_file_no][ns_file] ) ||
 						(rt02[ns_file][rt00[i].file_num] && rt02[current_file_no][ns_file] & DIRECT_OR_PUBLIC_INCLUDE)) )
 				||
-				( rt00[i].scope == S_LOCAL && ns_file == current_file_no && ns_file == rt00[i].file_num))
-				&& strcmp(simple_name, rt00[i].name) == 0) {
+				( rt00[i].scope == S_LOCAL && ns_file == current_file_no && ns_file == rt00[i].file_num)) {
 				return i;
 			}
-			i++;
 		}
 		return ATOM_M1;
 	}
@@ -4767,29 +7064,20 @@ int CRoutineId(int seq_num, int current_file_no, object name)
 		/* look up simple unqualified name */
 
 		/* first look for local or global symbol in the same file */
-		i = 0;
-		while (rt00[i].seq_num <= seq_num) {
+		for (i = next_routine(-1, routine_string); i >= 0; i = next_routine(i, routine_string)) {
 			f = rt00[i].file_num;
-			if ((current_file_no == f ||
-				 current_file_no == -f) &&
-				strcmp(routine_string, rt00[i].name) == 0) {
+			if (current_file_no == f || current_file_no == -f) {
 				return i;
 			}
-			i++;
 		}
 
 		/* then look for unique global, public or export symbol */
-		i = 0;
 		found = ATOM_M1;
 		out_of_path_found = 0;
 		in_path_found = 0;
-		while (rt00[i].seq_num <= seq_num) {
-
-			if (rt00[i].scope != S_LOCAL &&
-				strcmp(routine_string, rt00[i].name) == 0) {
-
-
+		for (i = next_routine(-1, routine_string); i >= 0; i = next_routine(i, routine_string)) {
 
+			if (rt00[i].scope != S_LOCAL) {
 				if(rt00[i].scope == S_GLOBAL ){
 					in_include_path = rt02[current_file_no][rt00[i].file_num] != NOT_INCLUDED;
 					if (in_include_path) {
@@ -4808,7 +7096,6 @@ int CRoutineId(int seq_num, int current_file_no, object name)
 					in_path_found++;
 				}
 			}
-			i++;
 		}
 
 		if( in_path_found != 1  && ((in_path_found + out_of_path_found) != 1) )
@@ -4873,6 +7160,14 @@ void eu_startup(struct routine_list *rl, struct ns_list *nl, unsigned char **ip,
 		InitTask();  // i.e. don't do this in a Euphoria .dll/.so
 }
 
+void eu_name_hash(struct name_hash *rh, struct name_hash *nh)
+/* Give CRoutineId() the hash tables of the routine and namespace lists
+   passed to eu_startup(). Without them it searches the lists. */
+{
+	rt03 = rh;
+	rt04 = nh;
+}
+
 void Position(object line, object col)
 /* Set two-d cursor position on screen.
    The Euphoria program assumes origin (1, 1) */
@@ -6029,8 +8324,6 @@ object find_from(object a, object bobj, object c)
 /* find object a as an element of sequence b starting from c*/
 {
 	int length;
-	object_ptr bp;
-	object bv;
 	s1_ptr b;
 
 	if (!IS_SEQUENCE(bobj))
@@ -6055,88 +8348,13 @@ object find_from(object a, object bobj, object c)
 		RTFatal("third argument of find/find_from() is out of bounds (%ld)", c);
 	}
 
-	bp = b->base;
-	bp += c - 1;
-	if (IS_ATOM_INT(a)) {
-		eudouble da = (eudouble)0;
-		int daok = 0;
-		while (TRUE) {
-			bv = *(++bp);
-			if (IS_ATOM_INT(bv)) {
-				if (a == bv) {
-					return bp - (object_ptr)b->base;
-				}
-			}
-			else if (IS_SEQUENCE(bv)) {
-				continue;  // can't be equal so skip it.
-			}
-			else if (bv == NOVALUE) {
-				break;  // we hit the end marker
-			}
-			else {  /* INT-DBL case */
-				if (! daok) {
-					da = (eudouble)a;
-					daok = 1;
-				}
-				if (da == DBL_PTR(bv)->dbl)
-					return bp - (object_ptr)b->base;
-			}
-		}
-	}
-
-	else if (IS_ATOM_DBL(a)) {
-		eudouble da = DBL_PTR(a)->dbl;
-		while (TRUE) {
-			bv = *(++bp);
-			if (IS_ATOM_INT(bv)) {
-				if (da == (eudouble)bv) {  /* DBL-INT case */
-					return bp - (object_ptr)b->base;
-				}
-			}
-			else if (IS_SEQUENCE(bv)) {
-				continue;  // can't be equal so skip it.
-			}
-			else if (bv == NOVALUE) {
-				break;  // we hit the end marker
-			}
-			else {  /* DBL-DBL case */
-				if (da == DBL_PTR(bv)->dbl)
-					return bp - (object_ptr)b->base;
-			}
-		}
-	}
-	else { // IS_SEQUENCE(a)
-		int a_len;
-
-		length -= c - 1;
-		a_len = SEQ_PTR(a)->length;
-		while (TRUE) {
-			bv = *(++bp);
-			if (bv == NOVALUE) {
-				break;  // we hit the end marker
-			}
-
-			if (IS_SEQUENCE(bv)) {
-				if (a_len == SEQ_PTR(bv)->length) {
-					/* a is SEQUENCE => not INT-INT case */
-					if (compare(a, bv) == 0)
-						return bp - (object_ptr)b->base;
-				}
-			}
-		}
-	}
-
-	return 0;
+	return find_in(a, b, b->base + c - 1);
 }
 
 object e_match_from(object aobj, object bobj, object c)
 /* find sequence a as a slice within sequence b
    sequence a may not be empty */
 {
-	int ntries, len_remaining;
-	object_ptr a1, b1, bp;
-	object_ptr ai, bi;
-	object av, bv;
 	int lengtha, lengthb;
 	s1_ptr a, b;
 
@@ -6171,35 +8389,946 @@ object e_match_from(object aobj, object bobj, object c)
 		RTFatal("third argument of match/match_from() is out of bounds (%ld)", c);
 	}
 
-	b1 = b->base;
-	bp = b1 + c - 1;
-	a1 = a->base;
-	ntries = lengthb - lengtha - c + 2; // will be max 0, when c is lengthb+1
-	while (--ntries >= 0) {
-		ai = a1;
-		bi = bp;
+	return match_in(a, b, b->base + c - 1);
+}
 
-		len_remaining = lengtha;
-		do {
-			ai++;
-			bi++;
-			av = *ai;
-			bv = *bi;
-			if (av != bv) {
-				if (IS_ATOM_INT(av) && IS_ATOM_INT(bv)) {
-					bp++;
-					break;
-				}
-				else if (compare(av, bv) != 0) {
-					bp++;
-					break;
-				}
+/* split(), split_any() and join() of std/sequence.e */
+
+static object split_piece(s1_ptr s, intptr_t start, intptr_t n)
+/* the n elements of s from index start, as a new sequence */
+{
+	s1_ptr r;
+	object_ptr p, q;
+	object x;
+
+	if (n == s->length) {
+		/* all of it, share the source */
+		RefDS(MAKE_SEQ(s));
+		return MAKE_SEQ(s);
+	}
+	r = NewS1(n);
+	p = s->base + start;
+	q = r->base;
+	while (--n >= 0) {
+		x = *p++;
+		Ref(x);
+		*(++q) = x;
+	}
+	return MAKE_SEQ(r);
+}
+
+static intptr_t split_next(s1_ptr s, object delim, intptr_t start)
+/* index of the next delim in s from index start, or 0. A sequence delim
+   is searched for as a slice, as match() does, an atom as find() does. */
+{
+	if (IS_SEQUENCE(delim))
+		return match_in(SEQ_PTR(delim), s, s->base + start - 1);
+	return find_in(delim, s, s->base + start - 1);
+}
+
+object ESplit(object x)
+/* split(source, delim, no_empty, limit) of std/sequence.e,
+   without interning the parts */
+{
+	s1_ptr s, r;
+	object delim;
+	int no_empty, rest;
+	intptr_t limit, len, dlen, start, pos, lim, pieces, full, i;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 4)
+		RTFatal("split expects {source, delim, no_empty, limit}");
+	s = SEQ_PTR(x);
+	if (!IS_SEQUENCE(s->base[1]))
+		RTFatal("first argument of split() must be a sequence");
+	if (!IS_ATOM_INT(s->base[3]) || !IS_ATOM_INT(s->base[4]))
+		RTFatal("no_empty and limit of split() must be integers");
+	delim = s->base[2];
+	no_empty = s->base[3] != 0;
+	limit = s->base[4];
+	s = SEQ_PTR(s->base[1]);
+	len = s->length;
+
+	if (len == 0)
+		return MAKE_SEQ(NewS1(0));
+
+	if (IS_SEQUENCE(delim) && SEQ_PTR(delim)->length == 0) {
+		/* each element on its own, and the rest once limit runs out */
+		rest = limit >= 1 && limit <= len;
+		pieces = rest ? limit : len;
+		r = NewS1(pieces + rest);
+		for (i = 1; i <= pieces; i++)
+			r->base[i] = split_piece(s, i, 1);
+		if (rest)
+			r->base[i] = split_piece(s, i, len - pieces);
+		return MAKE_SEQ(r);
+	}
+
+	dlen = IS_SEQUENCE(delim) ? SEQ_PTR(delim)->length : 1;
+
+	/* count the parts, so the result is made once */
+	pieces = 0;
+	full = 0;
+	start = 1;
+	lim = limit;
+	while (start <= len) {
+		pos = split_next(s, delim, start);
+		if (pos == 0)
+			break;
+		pieces++;
+		full += pos > start;
+		start = pos + dlen;
+		if (--lim == 0)
+			break;
+	}
+	pieces++;
+	full += start <= len;
+
+	r = NewS1(no_empty ? full : pieces);
+	i = 0;
+	start = 1;
+	lim = limit;
+	while (start <= len) {
+		pos = split_next(s, delim, start);
+		if (pos == 0)
+			break;
+		if (!no_empty || pos > start)
+			r->base[++i] = split_piece(s, start, pos - start);
+		start = pos + dlen;
+		if (--lim == 0)
+			break;
+	}
+	if (!no_empty || start <= len)
+		r->base[++i] = split_piece(s, start, len - start + 1);
+	return MAKE_SEQ(r);
+}
+
+static int set_table(s1_ptr set, char *table)
+/* mark the integers 0 to 255 of set in table. Returns TRUE if set
+   has nothing else in it. */
+{
+	object e;
+	intptr_t i;
+	int bytes = TRUE;
+
+	memset(table, 0, 256);
+	for (i = 1; i <= set->length; i++) {
+		e = set->base[i];
+		if (IS_ATOM_INT(e) && e >= 0 && e <= 255)
+			table[e] = 1;
+		else
+			bytes = FALSE;
+	}
+	return bytes;
+}
+
+static int in_set(object e, s1_ptr set, char *table, int bytes)
+/* is e an element of set, as find() sees it. table and bytes are from
+   set_table(). */
+{
+	intptr_t i;
+
+	if (IS_ATOM_INT(e)) {
+		if (e >= 0 && e <= 255 && table[e])
+			return TRUE;
+		if (bytes)
+			return FALSE;
+	}
+	for (i = 1; i <= set->length; i++) {
+		if (equal(e, set->base[i]))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+object ESplitAny(object x)
+/* split_any(source, delim, limit, no_empty) of std/sequence.e,
+   for a delim that is not empty */
+{
+	s1_ptr s, d, r;
+	object delim;
+	char in_delim[256];
+	int no_empty, pass, bytes;
+	intptr_t limit, len, start, pos, lim, pieces, i;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 4)
+		RTFatal("split_any expects {source, delim, limit, no_empty}");
+	s = SEQ_PTR(x);
+	if (!IS_SEQUENCE(s->base[1]))
+		RTFatal("first argument of split_any() must be a sequence");
+	if (!IS_ATOM_INT(s->base[3]) || !IS_ATOM_INT(s->base[4]))
+		RTFatal("limit and no_empty of split_any() must be integers");
+	delim = s->base[2];
+	limit = s->base[3];
+	no_empty = s->base[4] != 0;
+	s = SEQ_PTR(s->base[1]);
+	len = s->length;
+
+	if (!IS_SEQUENCE(delim)) {
+		d = NewS1(1);
+		Ref(delim);
+		d->base[1] = delim;
+		delim = MAKE_SEQ(d);
+	}
+	else
+		RefDS(delim);
+	d = SEQ_PTR(delim);
+
+	bytes = set_table(d, in_delim);
+
+	/* the first pass counts the parts, the second makes them */
+	r = NULL;
+	pieces = 0;
+	for (pass = 0; pass < 2; pass++) {
+		if (pass == 1)
+			r = NewS1(pieces);
+		i = 0;
+		start = 1;
+		lim = limit;
+		pos = 1;
+		while (TRUE) {
+			while (pos <= len && !in_set(s->base[pos], d, in_delim, bytes))
+				pos++;
+			if (pos > len)
+				break;
+			if (!no_empty || pos > start) {
+				i++;
+				if (r != NULL)
+					r->base[i] = split_piece(s, start, pos - start);
 			}
-			if (--len_remaining == 0)
-				return(bp - b1 + 1); /* perfect match */
-		} while (TRUE);
+			start = ++pos;
+			if (--lim == 0)
+				break;
+		}
+		if (!no_empty || start <= len) {
+			i++;
+			if (r != NULL)
+				r->base[i] = split_piece(s, start, len - start + 1);
+		}
+		pieces = i;
 	}
-	return 0; /* couldn't match */
+
+	DeRefDS(delim);
+	return MAKE_SEQ(r);
+}
+
+static object_ptr join_append(object_ptr q, object x)
+/* copy x after q, an atom as one element and a sequence as its elements.
+   Returns the last element copied. */
+{
+	object_ptr p;
+	intptr_t n;
+
+	if (!IS_SEQUENCE(x)) {
+		Ref(x);
+		*(++q) = x;
+		return q;
+	}
+	p = SEQ_PTR(x)->base;
+	n = SEQ_PTR(x)->length;
+	while (--n >= 0) {
+		x = *(++p);
+		Ref(x);
+		*(++q) = x;
+	}
+	return q;
+}
+
+object EJoin(object x)
+/* join(items, delim) of std/sequence.e */
+{
+	s1_ptr s, r;
+	object items, delim, e;
+	object_ptr q;
+	intptr_t n, len, dlen, i;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 2)
+		RTFatal("join expects {items, delim}");
+	items = SEQ_PTR(x)->base[1];
+	delim = SEQ_PTR(x)->base[2];
+	if (!IS_SEQUENCE(items))
+		RTFatal("first argument of join() must be a sequence");
+	s = SEQ_PTR(items);
+	n = s->length;
+	if (n == 0)
+		return MAKE_SEQ(NewS1(0));
+	if (n == 1 && IS_SEQUENCE(s->base[1])) {
+		RefDS(s->base[1]);
+		return s->base[1];
+	}
+
+	/* atoms are one element, sequences are their elements */
+	dlen = IS_SEQUENCE(delim) ? SEQ_PTR(delim)->length : 1;
+	len = (n - 1) * dlen;
+	for (i = 1; i <= n; i++) {
+		e = s->base[i];
+		len += IS_SEQUENCE(e) ? SEQ_PTR(e)->length : 1;
+	}
+
+	r = NewS1(len);
+	q = r->base;
+	for (i = 1; i <= n; i++) {
+		if (i > 1)
+			q = join_append(q, delim);
+		q = join_append(q, s->base[i]);
+	}
+	return MAKE_SEQ(r);
+}
+
+object ETrim(object x)
+/* trim_head(), trim_tail() and trim() of std/text.e: {source, what, how,
+   ret_index}, where how is 1 for the head, 2 for the tail and 3 for both */
+{
+	s1_ptr s, w;
+	object source, what;
+	char in_what[256];
+	int how, ret_index, bytes;
+	intptr_t len, lpos, rpos;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 4)
+		RTFatal("trim expects {source, what, how, ret_index}");
+	s = SEQ_PTR(x);
+	source = s->base[1];
+	what = s->base[2];
+	how = (int)s->base[3];
+	ret_index = s->base[4] != 0;
+	if (!IS_SEQUENCE(source))
+		RTFatal("first argument of trim() must be a sequence");
+	if (!IS_SEQUENCE(what))
+		RTFatal("second argument of trim() must be a sequence");
+	s = SEQ_PTR(source);
+	w = SEQ_PTR(what);
+	len = s->length;
+	bytes = set_table(w, in_what);
+
+	lpos = 1;
+	if (how & 1) {
+		while (lpos <= len && in_set(s->base[lpos], w, in_what, bytes))
+			lpos++;
+	}
+	rpos = len;
+	if (how & 2) {
+		while (rpos > (how == 3 ? lpos : 0) && in_set(s->base[rpos], w, in_what, bytes))
+			rpos--;
+	}
+
+	if (ret_index) {
+		if (how == 1)
+			return lpos;
+		if (how == 2)
+			return rpos;
+		s = NewS1(2);
+		s->base[1] = lpos;
+		s->base[2] = rpos;
+		return MAKE_SEQ(s);
+	}
+	if (lpos > rpos)
+		return MAKE_SEQ(NewS1(0));
+	return split_piece(s, lpos, rpos - lpos + 1);
+}
+
+
+/* lower() and upper() of std/text.e */
+
+/* The ASCII case change adds delta to the 26 integers from lo.
+   case_scan() returns the first of the n objects at p that is one of them
+   or is not an integer, or p + n. case_conv() copies the n objects at p to
+   q, changing the ones from lo to lo + 25, up to the first one that is not
+   an integer, which it returns, or p + n. */
+
+typedef object_ptr (*case_scan_t)(object_ptr p, intptr_t n, object lo);
+typedef object_ptr (*case_conv_t)(object_ptr q, object_ptr p, intptr_t n, object lo, object delta);
+
+#define IS_LETTER(x, lo) ((uintptr_t)((x) - (lo)) < 26)
+
+static object_ptr case_scan_c(object_ptr p, intptr_t n, object lo)
+{
+	object_ptr end = p + n;
+
+	for (; p < end; p++) {
+		if (!IS_ATOM_INT(*p) || IS_LETTER(*p, lo))
+			return p;
+	}
+	return end;
+}
+
+static object_ptr case_conv_c(object_ptr q, object_ptr p, intptr_t n, object lo, object delta)
+{
+	object_ptr end = p + n;
+
+	for (; p < end; p++, q++) {
+		if (!IS_ATOM_INT(*p))
+			return p;
+		*q = *p + (IS_LETTER(*p, lo) ? delta : 0);
+	}
+	return end;
+}
+
+#ifdef SCAN_SIMD
+/* objects that are not integers have the sign bit of x ^ (x << 1) set,
+   as in the find scans */
+
+static __m128i letters_sse2(__m128i v, __m128i lo)
+/* all ones in the lanes of v from lo to lo + 25 */
+{
+	__m128i t = _mm_sub_epi64(v, lo);
+	/* no 64 bit compare in SSE2: the high half must be 0, the low half 0 to 25 */
+	__m128i low = _mm_and_si128(_mm_cmpgt_epi32(t, _mm_set1_epi32(-1)),
+								_mm_cmplt_epi32(t, _mm_set1_epi32(26)));
+	__m128i high = _mm_cmpeq_epi32(t, _mm_setzero_si128());
+	return _mm_and_si128(_mm_shuffle_epi32(low, _MM_SHUFFLE(2, 2, 0, 0)),
+						 _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 3, 1, 1)));
+}
+
+static object_ptr case_scan_sse2(object_ptr p, intptr_t n, object lo)
+{
+	object_ptr end = p + n;
+	__m128i vlo = _mm_set1_epi64x(lo);
+	__m128i v;
+	int mask;
+
+	for (; end - p >= 2; p += 2) {
+		v = _mm_loadu_si128((__m128i *)p);
+		v = _mm_or_si128(letters_sse2(v, vlo), _mm_xor_si128(v, _mm_slli_epi64(v, 1)));
+		mask = _mm_movemask_pd(_mm_castsi128_pd(v));
+		if (mask)
+			return p + __builtin_ctz(mask);
+	}
+	return case_scan_c(p, end - p, lo);
+}
+
+static object_ptr case_conv_sse2(object_ptr q, object_ptr p, intptr_t n, object lo, object delta)
+{
+	object_ptr end = p + n;
+	__m128i vlo = _mm_set1_epi64x(lo);
+	__m128i vdelta = _mm_set1_epi64x(delta);
+	__m128i v;
+
+	for (; end - p >= 2; p += 2, q += 2) {
+		v = _mm_loadu_si128((__m128i *)p);
+		if (_mm_movemask_pd(_mm_castsi128_pd(_mm_xor_si128(v, _mm_slli_epi64(v, 1)))))
+			break;
+		v = _mm_add_epi64(v, _mm_and_si128(letters_sse2(v, vlo), vdelta));
+		_mm_storeu_si128((__m128i *)q, v);
+	}
+	return case_conv_c(q, p, end - p, lo, delta);
+}
+
+__attribute__((target("avx2")))
+static object_ptr case_scan_avx2(object_ptr p, intptr_t n, object lo)
+{
+	object_ptr end = p + n;
+	__m256i vlo = _mm256_set1_epi64x(lo - 1);
+	__m256i vhi = _mm256_set1_epi64x(lo + 26);
+	__m256i v;
+	int mask;
+
+	for (; end - p >= 4; p += 4) {
+		v = _mm256_loadu_si256((__m256i *)p);
+		v = _mm256_or_si256(
+				_mm256_and_si256(_mm256_cmpgt_epi64(v, vlo), _mm256_cmpgt_epi64(vhi, v)),
+				_mm256_xor_si256(v, _mm256_slli_epi64(v, 1)));
+		mask = _mm256_movemask_pd(_mm256_castsi256_pd(v));
+		if (mask)
+			return p + __builtin_ctz(mask);
+	}
+	return case_scan_sse2(p, end - p, lo);
+}
+
+__attribute__((target("avx2")))
+static object_ptr case_conv_avx2(object_ptr q, object_ptr p, intptr_t n, object lo, object delta)
+{
+	object_ptr end = p + n;
+	__m256i vlo = _mm256_set1_epi64x(lo - 1);
+	__m256i vhi = _mm256_set1_epi64x(lo + 26);
+	__m256i vdelta = _mm256_set1_epi64x(delta);
+	__m256i v, letters;
+
+	for (; end - p >= 4; p += 4, q += 4) {
+		v = _mm256_loadu_si256((__m256i *)p);
+		if (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_xor_si256(v, _mm256_slli_epi64(v, 1)))))
+			break;
+		letters = _mm256_and_si256(_mm256_cmpgt_epi64(v, vlo), _mm256_cmpgt_epi64(vhi, v));
+		v = _mm256_add_epi64(v, _mm256_and_si256(letters, vdelta));
+		_mm256_storeu_si256((__m256i *)q, v);
+	}
+	return case_conv_sse2(q, p, end - p, lo, delta);
+}
+
+__attribute__((target("avx512f")))
+static object_ptr case_scan_avx512(object_ptr p, intptr_t n, object lo)
+{
+	object_ptr end = p + n;
+	__m512i vlo = _mm512_set1_epi64(lo);
+	__m512i v26 = _mm512_set1_epi64(26);
+	__m512i v;
+	__mmask8 mask;
+
+	for (; end - p >= 8; p += 8) {
+		v = _mm512_loadu_si512((void *)p);
+		mask = _mm512_cmplt_epu64_mask(_mm512_sub_epi64(v, vlo), v26) |
+			   _mm512_cmplt_epi64_mask(_mm512_xor_si512(v, _mm512_slli_epi64(v, 1)),
+									   _mm512_setzero_si512());
+		if (mask)
+			return p + __builtin_ctz(mask);
+	}
+	return case_scan_sse2(p, end - p, lo);
+}
+
+__attribute__((target("avx512f")))
+static object_ptr case_conv_avx512(object_ptr q, object_ptr p, intptr_t n, object lo, object delta)
+{
+	object_ptr end = p + n;
+	__m512i vlo = _mm512_set1_epi64(lo);
+	__m512i v26 = _mm512_set1_epi64(26);
+	__m512i vdelta = _mm512_set1_epi64(delta);
+	__m512i v;
+
+	for (; end - p >= 8; p += 8, q += 8) {
+		v = _mm512_loadu_si512((void *)p);
+		if (_mm512_cmplt_epi64_mask(_mm512_xor_si512(v, _mm512_slli_epi64(v, 1)),
+									_mm512_setzero_si512()))
+			break;
+		v = _mm512_mask_add_epi64(v, _mm512_cmplt_epu64_mask(_mm512_sub_epi64(v, vlo), v26),
+								  v, vdelta);
+		_mm512_storeu_si512((void *)q, v);
+	}
+	return case_conv_sse2(q, p, end - p, lo, delta);
+}
+
+static object_ptr case_scan_init(object_ptr p, intptr_t n, object lo);
+static object_ptr case_conv_init(object_ptr q, object_ptr p, intptr_t n, object lo, object delta);
+static case_scan_t case_scan = case_scan_init;
+static case_conv_t case_conv = case_conv_init;
+
+static void case_simd_init()
+/* picks the widest scans this processor can run, on the first call */
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		case_scan = case_scan_avx512;
+		case_conv = case_conv_avx512;
+	}
+	else if (__builtin_cpu_supports("avx2")) {
+		case_scan = case_scan_avx2;
+		case_conv = case_conv_avx2;
+	}
+	else {
+		case_scan = case_scan_sse2;
+		case_conv = case_conv_sse2;
+	}
+}
+
+static object_ptr case_scan_init(object_ptr p, intptr_t n, object lo)
+{
+	case_simd_init();
+	return case_scan(p, n, lo);
+}
+
+static object_ptr case_conv_init(object_ptr q, object_ptr p, intptr_t n, object lo, object delta)
+{
+	case_simd_init();
+	return case_conv(q, p, n, lo, delta);
+}
+#else
+#define case_scan case_scan_c
+#define case_conv case_conv_c
+#endif
+
+static object case_ascii(object x, object lo, object delta)
+/* x with delta added to its atoms from lo to lo + 25, at any depth.
+   Returns x itself, with a new reference, when there are none. */
+{
+	s1_ptr s, r;
+	object_ptr p, end, q;
+	object e;
+	eudouble d;
+	intptr_t n, i, k;
+
+	if (IS_ATOM_INT(x))
+		return IS_LETTER(x, lo) ? x + delta : x;
+
+	if (IS_ATOM_DBL(x)) {
+		d = DBL_PTR(x)->dbl;
+		if (d >= (eudouble)lo && d <= (eudouble)(lo + 25))
+			return NewDouble(d + (eudouble)delta);
+		RefDS(x);
+		return x;
+	}
+
+	s = SEQ_PTR(x);
+	n = s->length;
+	p = s->base + 1;
+	end = p + n;
+
+	/* find the first element that changes */
+	e = NOVALUE;
+	for (q = p; ; q++) {
+		q = case_scan(q, end - q, lo);
+		if (q == end) {
+			RefDS(x);
+			return x;
+		}
+		if (IS_ATOM_INT(*q))
+			break;
+		e = case_ascii(*q, lo, delta);
+		if (e != *q)
+			break;
+		DeRefDS(e);
+		e = NOVALUE;
+	}
+
+	r = NewS1(n);
+	i = q - p;
+	for (k = 0; k < i; k++) {
+		Ref(p[k]);
+		r->base[k + 1] = p[k];
+	}
+	if (e != NOVALUE)
+		r->base[++i] = e;
+	/* r->base + 1 + i is the next one to fill, p + i the one it comes from */
+	while (p + i < end) {
+		q = case_conv(r->base + 1 + i, p + i, end - (p + i), lo, delta);
+		i = q - p;
+		if (q == end)
+			break;
+		r->base[1 + i] = case_ascii(*q, lo, delta);
+		i++;
+	}
+	return MAKE_SEQ(r);
+}
+
+/* The case change of set_encoding_properties() changes each atom found in
+   one set to the atom in the same place in the other, as mapping() of
+   std/sequence.e does. With a "UTF-8" encoding, a sequence of bytes is
+   decoded first and encoded again after. The sets are indexed once and
+   kept while they are in use. */
+
+struct case_table {
+	object from;           /* the atoms to change, a reference is held */
+	object to;             /* what they change to */
+	intptr_t byte[256];    /* index in from of each of 0 to 255, 0 if none */
+	intptr_t *wide;        /* {integer, index in from} pairs of the others, sorted */
+	intptr_t nwide;
+	int utf8;              /* TRUE if sequences of bytes are UTF-8 text */
+};
+
+static struct case_table case_tables[2];  /* for lower() and for upper() */
+
+static int wide_cmp(const void *a, const void *b)
+{
+	const intptr_t *x = (const intptr_t *)a, *y = (const intptr_t *)b;
+
+	if (x[0] != y[0])
+		return (x[0] < y[0]) ? -1 : 1;
+	return (x[1] < y[1]) ? -1 : (x[1] > y[1]);
+}
+
+static int integral(object e, intptr_t *c)
+/* is atom e an integer, or a double with an integer value */
+{
+	eudouble d;
+
+	if (IS_ATOM_INT(e)) {
+		*c = e;
+		return TRUE;
+	}
+	if (IS_ATOM_DBL(e)) {
+		d = DBL_PTR(e)->dbl;
+		if (d >= MININT_DBL && d <= MAXINT_DBL && d == (eudouble)(intptr_t)d) {
+			*c = (intptr_t)d;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void case_table_set(struct case_table *t, object from, object to, int utf8)
+/* index the sets from and to, unless t already has them */
+{
+	s1_ptr f;
+	intptr_t i, c;
+
+	t->utf8 = utf8;
+	if (t->from == from && t->to == to)
+		return;
+	if (IS_SEQUENCE(t->from)) {
+		DeRefDS(t->from);
+		DeRefDS(t->to);
+		EFree((char *)t->wide);
+	}
+	RefDS(from);
+	RefDS(to);
+	t->from = from;
+	t->to = to;
+
+	f = SEQ_PTR(from);
+	memset(t->byte, 0, sizeof(t->byte));
+	t->wide = (intptr_t *)EMalloc((2 * f->length + 2) * sizeof(intptr_t));
+	t->nwide = 0;
+	for (i = 1; i <= f->length; i++) {
+		if (!integral(f->base[i], &c))
+			continue;
+		if (c >= 0 && c <= 255) {
+			if (t->byte[c] == 0)
+				t->byte[c] = i;
+		}
+		else {
+			t->wide[2 * t->nwide] = c;
+			t->wide[2 * t->nwide + 1] = i;
+			t->nwide++;
+		}
+	}
+	qsort(t->wide, t->nwide, 2 * sizeof(intptr_t), wide_cmp);
+}
+
+static object case_atom(struct case_table *t, object c)
+/* what atom c changes to, or c */
+{
+	intptr_t i, lo, hi, mid, k;
+	s1_ptr f;
+
+	i = 0;
+	if (IS_ATOM_INT(c) && c >= 0 && c <= 255)
+		i = t->byte[c];
+	else if (IS_ATOM_INT(c)) {
+		/* the first pair with c, which has the lowest index */
+		lo = 0;
+		hi = t->nwide;
+		while (lo < hi) {
+			mid = (lo + hi) / 2;
+			if (t->wide[2 * mid] < c)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		if (lo < t->nwide && t->wide[2 * lo] == c)
+			i = t->wide[2 * lo + 1];
+	}
+	else {
+		f = SEQ_PTR(t->from);
+		for (k = 1; k <= f->length; k++) {
+			if (equal(c, f->base[k])) {
+				i = k;
+				break;
+			}
+		}
+	}
+
+	if (i == 0 || i > SEQ_PTR(t->to)->length)
+		return c;
+	return SEQ_PTR(t->to)->base[i];
+}
+
+static intptr_t utf8_decode(object_ptr p, intptr_t n, intptr_t *cp)
+/* length of the UTF-8 character in the n integers 0 to 255 at p,
+   and its code point in *cp, or 0 if they don't start with one */
+{
+	intptr_t b, c, len, least, i;
+
+	b = p[0];
+	if (b < 0x80) {
+		*cp = b;
+		return 1;
+	}
+	if (b < 0xC2)
+		return 0;
+	if (b < 0xE0) {
+		len = 2;
+		c = b & 0x1F;
+		least = 0x80;
+	}
+	else if (b < 0xF0) {
+		len = 3;
+		c = b & 0x0F;
+		least = 0x800;
+	}
+	else if (b < 0xF5) {
+		len = 4;
+		c = b & 0x07;
+		least = 0x10000;
+	}
+	else
+		return 0;
+	if (n < len)
+		return 0;
+	for (i = 1; i < len; i++) {
+		b = p[i];
+		if ((b & 0xC0) != 0x80)
+			return 0;
+		c = (c << 6) | (b & 0x3F);
+	}
+	if (c < least || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+		return 0;
+	*cp = c;
+	return len;
+}
+
+static intptr_t utf8_encode(intptr_t c, object_ptr q)
+/* store code point c as UTF-8 at q, unless q is NULL. Returns its length. */
+{
+	intptr_t len, i;
+
+	len = (c < 0x80) ? 1 : (c < 0x800) ? 2 : (c < 0x10000) ? 3 : 4;
+	if (q != NULL) {
+		if (len == 1)
+			q[0] = c;
+		else {
+			for (i = len - 1; i > 0; i--) {
+				q[i] = 0x80 | (c & 0x3F);
+				c >>= 6;
+			}
+			q[0] = ((0xF00 >> len) & 0xFF) | c;
+		}
+	}
+	return len;
+}
+
+static object case_utf8(struct case_table *t, object x)
+/* case change of the UTF-8 text x, a sequence of integers 0 to 255.
+   Bytes that are not UTF-8 are left as they are. */
+{
+	s1_ptr s, r;
+	object_ptr p, q;
+	object v;
+	intptr_t n, pos, len, cp, out;
+	int pass, changed;
+
+	s = SEQ_PTR(x);
+	p = s->base + 1;
+	n = s->length;
+	r = NULL;
+	q = NULL;
+	out = 0;
+	changed = FALSE;
+
+	/* the first pass measures the result, the second fills it in */
+	for (pass = 0; pass < 2; pass++) {
+		if (pass == 1) {
+			if (!changed) {
+				RefDS(x);
+				return x;
+			}
+			r = NewS1(out);
+			q = r->base + 1;
+		}
+		out = 0;
+		for (pos = 0; pos < n; pos += len) {
+			len = utf8_decode(p + pos, n - pos, &cp);
+			if (len == 0) {
+				/* not UTF-8, keep the byte */
+				len = 1;
+				cp = -1;
+				v = -1;
+			}
+			else
+				v = case_atom(t, cp);
+			if (v != cp && IS_ATOM_INT(v) && v >= 0 && v <= 0x10FFFF) {
+				out += utf8_encode(v, q ? q + out : NULL);
+				changed = TRUE;
+			}
+			else {
+				if (q != NULL)
+					memcpy(q + out, p + pos, len * sizeof(object));
+				out += len;
+			}
+		}
+	}
+	return MAKE_SEQ(r);
+}
+
+static object case_map(struct case_table *t, object x)
+/* mapping(x, from, to) of std/sequence.e for the sets of t. Returns x
+   itself, with a new reference, when nothing changes. */
+{
+	s1_ptr s, r;
+	object e, v;
+	intptr_t n, i, k;
+
+	if (!IS_SEQUENCE(x)) {
+		v = case_atom(t, x);
+		Ref(v);
+		return v;
+	}
+
+	s = SEQ_PTR(x);
+	n = s->length;
+	if (t->utf8) {
+		for (i = 1; i <= n; i++) {
+			e = s->base[i];
+			if (!IS_ATOM_INT(e) || e < 0 || e > 255)
+				break;
+		}
+		if (i > n && n > 0)
+			return case_utf8(t, x);
+	}
+
+	/* find the first element that changes */
+	v = NOVALUE;
+	for (i = 1; i <= n; i++) {
+		e = s->base[i];
+		if (IS_SEQUENCE(e)) {
+			v = case_map(t, e);
+			if (v != e)
+				break;
+			DeRefDS(v);
+		}
+		else {
+			v = case_atom(t, e);
+			if (v != e) {
+				Ref(v);
+				break;
+			}
+		}
+	}
+	if (i > n) {
+		RefDS(x);
+		return x;
+	}
+
+	r = NewS1(n);
+	for (k = 1; k < i; k++) {
+		e = s->base[k];
+		Ref(e);
+		r->base[k] = e;
+	}
+	r->base[i] = v;
+	for (k = i + 1; k <= n; k++) {
+		e = s->base[k];
+		if (IS_SEQUENCE(e))
+			v = case_map(t, e);
+		else {
+			v = case_atom(t, e);
+			Ref(v);
+		}
+		r->base[k] = v;
+	}
+	return MAKE_SEQ(r);
+}
+
+object EChangeCase(object x)
+/* lower() and upper() of std/text.e: {x, to_upper, from, to, utf8}.
+   When from is empty only the ASCII letters change. */
+{
+	s1_ptr s;
+	object from, to;
+	int up;
+
+	if (!IS_SEQUENCE(x) || SEQ_PTR(x)->length != 5)
+		RTFatal("change case expects {x, to_upper, from, to, utf8}");
+	s = SEQ_PTR(x);
+	up = s->base[2] != 0;
+	from = s->base[3];
+	to = s->base[4];
+	if (!IS_SEQUENCE(from) || !IS_SEQUENCE(to))
+		RTFatal("the case sets must be sequences");
+
+	if (SEQ_PTR(from)->length == 0) {
+		if (up)
+			return case_ascii(s->base[1], 'a', 'A' - 'a');
+		return case_ascii(s->base[1], 'A', 'a' - 'A');
+	}
+	case_table_set(&case_tables[up], from, to, s->base[5] != 0);
+	return case_map(&case_tables[up], s->base[1]);
 }
 
 void Replace( replace_ptr rb )
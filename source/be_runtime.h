@@ -6,6 +6,9 @@
 #include "reswords.h"
 
 void de_reference(s1_ptr a);
+int drain_frees(intptr_t budget);
+object set_free_budget(object x);
+extern intptr_t free_budget;
 
 
 #define FIRST_USER_FILE 3
@@ -115,6 +118,13 @@ object EGetEnv(object name);
 
 object EPrintf(object file_no, object format_obj, object values);
 void StdPrint(object fn, object a, int new_lines);
+object ESprint(object a);
+object EGetValue(object x);
+object ESplit(object x);
+object ESplitAny(object x);
+object EJoin(object x);
+object ETrim(object x);
+object EChangeCase(object x);
 void EPuts(object file_no, object obj);
 void Print(IFILE f, object a, int lines, int width, int init_chars, int pretty);
 int show_ascii_char(IFILE print_file, int iv);
@@ -133,7 +143,13 @@ void setran();
 void call_crash_routines();
 
 object compare(object a, object b);
+object equal(object a, object b);
 object calc_hash(object a, object b);
+object hash_init(object x);
+object hash_update(object x);
+object hash_final(object x);
+object intern(object x);
+object intern_purge();
 void ctrace(char *line);
 void Position(object line, object col);
 extern int charcopy(char *, int, char *, int);
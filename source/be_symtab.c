@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -41,6 +42,18 @@ int e_routine_next = 0;       /* index of next available element */
 /* Local variables */
 /*******************/
 static int e_routine_size = 0;   /* number of symbol table pointers allocated */
+static int *e_routine_of = NULL; /* routine id + 1 of each fe.st entry, 0 if none */
+
+/* Hash index of the names on the symbol list that starts at TopLevelSub->next,
+   built the first time RTLookup() is called. Symbols are kept by their index
+   in fe.st. Each hash chain holds its symbols in list order. The list doesn't
+   change once the program is running. */
+static int *sym_first = NULL;   /* first symbol of each hash chain, 0 if none */
+static int *sym_chain;          /* next symbol in the same hash chain, 0 if none */
+static int *sym_rank;           /* position of each symbol on the list, from 1 */
+static uint32_t sym_mask;       /* number of hash chains - 1 */
+static symtab_ptr cutoff_stop = NULL;  /* stop that cutoff_rank was found for */
+static int cutoff_rank;
 
 /**********************/
 /* Declared functions */
@@ -150,14 +163,99 @@ long block_contains_line( symtab_ptr block, unsigned long line){
 	return (block == 0) || ((block->u.block.first_line <= line) && (block->u.block.last_line >= line));
 }
 
+static uint32_t sym_hash(char *name)
+/* FNV-1a hash of a symbol name */
+{
+	uint32_t h = 2166136261u;
+
+	while (*name) {
+		h ^= (unsigned char)*name++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static void sym_index_build()
+/* index the names of the symbols on the list after TopLevelSub */
+{
+	symtab_ptr s;
+	int *order;
+	int len, count, i, k;
+	uint32_t h;
+
+	len = (int)fe.st[0].obj;
+	sym_chain = (int *)EMalloc((len + 1) * sizeof(int));
+	sym_rank = (int *)EMalloc((len + 1) * sizeof(int));
+	order = (int *)EMalloc((len + 1) * sizeof(int));
+	count = 0;
+	for (s = TopLevelSub->next; s != NULL; s = s->next) {
+		k = s - fe.st;
+		sym_rank[k] = ++count;
+		order[count] = k;
+	}
+
+	for (sym_mask = 15; sym_mask < (uint32_t)count; sym_mask = sym_mask * 2 + 1)
+		;
+	sym_first = (int *)EMalloc((sym_mask + 1) * sizeof(int));
+	memset(sym_first, 0, (sym_mask + 1) * sizeof(int));
+
+	/* push from the end of the list, so each chain is in list order */
+	for (i = count; i >= 1; i--) {
+		k = order[i];
+		sym_chain[k] = 0;
+		if (fe.st[k].name == NULL)
+			continue;
+		h = sym_hash(fe.st[k].name) & sym_mask;
+		sym_chain[k] = sym_first[h];
+		sym_first[h] = k;
+	}
+	EFree((char *)order);
+}
+
+static symtab_ptr next_named(symtab_ptr s, char *name)
+/* the next symbol after s on the list that is called name, or NULL.
+   s = NULL gives the first one. */
+{
+	int k;
+
+	if (s == NULL)
+		k = sym_first[sym_hash(name) & sym_mask];
+	else
+		k = sym_chain[s - fe.st];
+	for (; k != 0; k = sym_chain[k]) {
+		if (strcmp(name, fe.st[k].name) == 0)
+			return &fe.st[k];
+	}
+	return NULL;
+}
+
+static int list_cutoff(symtab_ptr stop)
+/* position on the list of the first symbol after stop that isn't private,
+   where the lookups of RTLookup() end */
+{
+	symtab_ptr s;
+
+	if (stop != cutoff_stop) {
+		cutoff_stop = stop;
+		cutoff_rank = 0;
+		for (s = TopLevelSub->next; s != NULL; s = s->next) {
+			cutoff_rank++;
+			if (s > stop && s->scope != S_PRIVATE)
+				return cutoff_rank;
+		}
+		cutoff_rank = INT_MAX;
+	}
+	return cutoff_rank;
+}
+
 symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int stlen, unsigned long current_line )
 /* Look up a name (routine or var) in the symbol table at runtime.
    The name must have been defined earlier in the source than
    where we are currently executing. The name may be a simple "name"
-   or "ns:name". Speed is not too critical. This lookup is only used 
-   in interactive trace mode, and in looking up routine id's, 
-   which should normally only be done once for an indirectly-callable 
-   routine. */
+   or "ns:name". This lookup is used in interactive trace mode, and in
+   looking up routine id's, which programs may do for names they only
+   know at run time. The symbols with the name are found through the
+   name index, in the order they are on the symbol list. */
 {
 	symtab_ptr proc, s, global_found, stop;
 	char *colon;
@@ -168,6 +266,7 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 	int found_outside_path;
 	int s_in_include_path;
 	int did_find = 0;
+	int cutoff;
 	
 	if (pc == NULL) {
 		proc = routine;
@@ -180,6 +279,10 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 		return NULL;
 
 	stop = &fe.st[stlen];
+	if (sym_first == NULL)
+		sym_index_build();
+	/* searches of the list end at this symbol */
+	cutoff = list_cutoff(stop);
 		
 	colon = strchr(name, ':');
 	
@@ -204,15 +307,12 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 		}
 
 		/* step 1: look up NAMESPACE symbol */
-		for (s = TopLevelSub->next; s != NULL; s = s->next) {
+		for (s = next_named(NULL, ns); s != NULL && sym_rank[s - fe.st] <= cutoff; s = next_named(s, ns)) {
 			if ( (fe.includes[file][s->file_no] & DIRECT_OR_PUBLIC_INCLUDE) && 
-				s->token == NAMESPACE && strcmp(ns, s->name) == 0) {
+				s->token == NAMESPACE) {
 				did_find = 1;
 				break;
 			}
-			else if( s > stop && s->scope != S_PRIVATE ){
-				break;
-			}
 		}
 		
 		if (!did_find)
@@ -230,8 +330,8 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 			name++;
 		
 		/* find name in ns file */
-		for (s = TopLevelSub->next; s != NULL && ( s <= stop || s->scope == S_PRIVATE); s = s->next) {
-			if( (( s->scope == S_PUBLIC
+		for (s = next_named(NULL, name); s != NULL && sym_rank[s - fe.st] < cutoff; s = next_named(s, name)) {
+			if( ( s->scope == S_PUBLIC
 					&& ( (s->file_no == ns_file && fe.includes[file][ns_file] & DIRECT_OR_PUBLIC_INCLUDE ) || 
 						(fe.includes[ns_file][s->file_no] & PUBLIC_INCLUDE &&
 						 fe.includes[file][ns_file] & DIRECT_OR_PUBLIC_INCLUDE)))
@@ -243,8 +343,7 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 					&& ( (s->file_no == ns_file  && fe.includes[file][ns_file] ) || 
 						(fe.includes[ns_file][s->file_no] && fe.includes[file][ns_file] & DIRECT_OR_PUBLIC_INCLUDE)) )
 				||
-				( s->scope == S_LOCAL && ns_file == file && ns_file == s->file_no))
-				&& strcmp(name, s->name) == 0) {
+				( s->scope == S_LOCAL && ns_file == file && ns_file == s->file_no)) {
 				return s;
 			}
 		}
@@ -266,7 +365,7 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 		}
 		
 		/* try to match a LOCAL, EXPORT or GLOBAL symbol in the same source file */
-		for (s = TopLevelSub->next; s != NULL && ( s <= stop || s->scope == S_PRIVATE); s = s->next) {
+		for (s = next_named(NULL, name); s != NULL && sym_rank[s - fe.st] < cutoff; s = next_named(s, name)) {
 			
 			if (s->file_no == file ){
 				
@@ -287,12 +386,9 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 					case S_GLOBAL:
 					case S_PUBLIC:
 					case S_EXPORT:
-						if( strcmp(name, s->name) == 0) {  
-							// shouldn't really be able to see GLOOP_VARs unless we are
-							// currently inside the loop - only affects interactive var display
-							return s;
-						}
-						break;
+						// shouldn't really be able to see GLOOP_VARs unless we are
+						// currently inside the loop - only affects interactive var display
+						return s;
 					
 				}
 			}
@@ -302,8 +398,8 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 		global_found = NULL;
 		found_in_path = 0;
 		found_outside_path = 0;
-		for (s = TopLevelSub->next; s != NULL && ( s <= stop || s->scope == S_PRIVATE); s = s->next) {
-			if (s->scope == S_GLOBAL && strcmp(name, s->name) == 0) {
+		for (s = next_named(NULL, name); s != NULL && sym_rank[s - fe.st] < cutoff; s = next_named(s, name)) {
+			if (s->scope == S_GLOBAL) {
 			
 				s_in_include_path = fe.includes[file][s->file_no] != NOT_INCLUDED; // symbol_in_include_path( s, file, NULL );
 				if ( s_in_include_path){
@@ -316,8 +412,7 @@ symtab_ptr RTLookup(char *name, int file, intptr_t *pc, symtab_ptr routine, int
 				}
 			}
 			else if( ((s->scope == S_EXPORT && (fe.includes[file][s->file_no] & DIRECT_INCLUDE)) 
-				|| (s->scope == S_PUBLIC && (fe.includes[file][s->file_no] & DIRECT_OR_PUBLIC_INCLUDE) ) ) 
-				&& strcmp(name, s->name) == 0){
+				|| (s->scope == S_PUBLIC && (fe.includes[file][s->file_no] & DIRECT_OR_PUBLIC_INCLUDE) ) ) ){
 					global_found = s;
 					found_in_path++;
 			}
@@ -358,10 +453,13 @@ int RoutineId(symtab_ptr current_sub, object name, int file_no)
 					  p->token != TYPE))
 		return ATOM_M1;
 
-	for (i = 0; i < e_routine_next; i++) {
-		if (e_routine[i] == p)
-			return i;  // routine was already assigned an id
+	if (e_routine_of == NULL) {
+		i = ((int)fe.st[0].obj + 1) * sizeof(int);
+		e_routine_of = (int *)EMalloc(i);
+		memset(e_routine_of, 0, i);
 	}
+	if (e_routine_of[p - fe.st])
+		return e_routine_of[p - fe.st] - 1;  // routine was already assigned an id
 	
 	if (e_routine_next >= e_routine_size) {
 		if (e_routine == NULL) {
@@ -385,6 +483,7 @@ int RoutineId(symtab_ptr current_sub, object name, int file_no)
 	}
 	
 	e_routine[e_routine_next] = p; // save the symtab_ptr
+	e_routine_of[p - fe.st] = e_routine_next + 1;
 	 
 	return e_routine_next++;
 }
@@ -384,6 +384,7 @@ void task_yield()
 {   
 	double now;
 	
+	drain_frees(free_budget);
 	now = current_time();
 	if (tcb[current_task].status == ST_ACTIVE) {
 		if (tcb[current_task].runs_left > 0) {
@@ -1123,7 +1124,13 @@ void scheduler(double now)
 			
 		if (tcb[earliest_task].type == T_REAL_TIME) {
 			// no time-sharing tasks, Wait and run this real-time task
-			now = Wait(start_time - now);
+			// spend the idle time releasing any deferred garbage first
+			while (drain_frees(free_budget) && current_time() < start_time) {
+			}
+			now = current_time();
+			if (start_time > now) {
+				now = Wait(start_time - now);
+			}
 		}
 	}
 
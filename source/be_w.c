@@ -298,7 +298,7 @@ static char *expanded_ptr;
 static char *expanded_end;
 static int must_flush = TRUE; /* flush output to screen or not */
 static int collect_next;   /* place to store next collect output */
-static int collect_free;   /* number of chars of empty space remaining */
+static int collect_size;   /* number of chars collect has room for */
 #ifdef __unix
 // we need to record everything written to the screen
 struct char_cell screen_image[MAX_LINES][MAX_COLS];
@@ -959,31 +959,25 @@ void screen_output(IFILE f, char *out_string)
 /* f is output file, or NULL if debug screen, or DOING_SPRINTF */
 /* out_string is null-terminated string of characters to write out */
 {
-    int len, collect_len;
+    int len;
 
     if ((intptr_t)f == DOING_SPRINTF) {
-        /* save characters as a C string in memory */
+        /* save characters as a C string in memory, growing it by
+           doubling so long results are built in linear time */
         len = strlen(out_string);
         if (collect == NULL) {
-			collect_free = 80;
-			collect_len = len + collect_free;
-            collect = EMalloc(collect_len + 1);
-			copy_string(collect, out_string, collect_len);
-            collect_next = len;
+            collect_size = len + 80;
+            collect = EMalloc(collect_size + 1);
+            collect_next = 0;
         }
-        else {
-            if (len > collect_free) {
-				collect_free = len + 200;
-				collect_len = collect_next + collect_free;
-                collect = ERealloc(collect, collect_len + 1);
-			} else {
-				collect_len = len;
-			}
-
-			copy_string(collect+collect_next, out_string, len+1);
-            collect_free -= len;
-            collect_next += len;
+        else if (collect_next + len > collect_size) {
+            collect_size *= 2;
+            if (collect_size < collect_next + len)
+                collect_size = collect_next + len;
+            collect = ERealloc(collect, collect_size + 1);
         }
+        memcpy(collect + collect_next, out_string, len + 1);
+        collect_next += len;
     }
 
     else if (f == NULL) {
@@ -0,0 +1,166 @@
+-- (c) Copyright - See License.txt
+--
+-- Runs several compiler processes at once for the direct build
+
+ifdef ETYPE_CHECK then
+	with type_check
+elsedef
+	without type_check
+end ifdef
+
+include std/convert.e
+include std/dll.e
+include std/filesys.e
+include std/io.e
+include std/os.e
+include std/pipeio.e as pipeio
+
+ifdef UNIX then
+	constant
+		libc = dll:open_dll({ "libc.so.7", "libc.so", "libc.dylib", "" }),
+		sysconf = dll:define_c_func(libc, "sysconf", {dll:C_INT}, dll:C_LONG)
+
+	ifdef LINUX then
+		constant SC_NPROCESSORS_ONLN = 84
+	elsifdef OSX or FREEBSD then
+		constant SC_NPROCESSORS_ONLN = 58
+	elsifdef OPENBSD then
+		constant SC_NPROCESSORS_ONLN = 503
+	elsifdef NETBSD then
+		constant SC_NPROCESSORS_ONLN = 1002
+	elsedef
+		constant SC_NPROCESSORS_ONLN = -1
+	end ifdef
+end ifdef
+
+--**
+-- Returns the number of processors that are online, or 1 if that is unknown.
+
+export function cpu_count()
+	atom count = 1
+
+	ifdef WINDOWS then
+		object n = getenv("NUMBER_OF_PROCESSORS")
+		if sequence(n) then
+			count = to_integer(n, 1)
+		end if
+	elsedef
+		if sysconf != -1 and SC_NPROCESSORS_ONLN != -1 then
+			count = c_func(sysconf, {SC_NPROCESSORS_ONLN})
+		end if
+	end ifdef
+
+	if count < 1 then
+		count = 1
+	end if
+	return count
+end function
+
+-- runs cmd with its output going to log_name, without waiting for it
+function start_job(sequence cmd, sequence log_name)
+	object pipes = pipeio:create()
+	if atom(pipes) then
+		return -1
+	end if
+
+	ifdef WINDOWS then
+		cmd = sprintf(`cmd /s /c "%s > "%s" 2>&1"`, { cmd, log_name })
+	elsedef
+		cmd = sprintf(`%s > "%s" 2>&1`, { cmd, log_name })
+	end ifdef
+
+	object p = pipeio:exec(cmd, pipes)
+	if atom(p) then
+		for i = 1 to length(pipes[pipeio:PARENT]) do
+			pipeio:close(pipes[pipeio:PARENT][i])
+		end for
+	end if
+	return p
+end function
+
+-- forgets a finished process: closes our ends of its pipes
+procedure end_job(sequence p)
+	pipeio:close(p[pipeio:STDIN])
+	pipeio:close(p[pipeio:STDOUT])
+	pipeio:close(p[pipeio:STDERR])
+end procedure
+
+--**
+-- Runs the shell commands in ##cmds##, up to ##jobs## of them at a time.
+--
+-- Each command's output is collected in a temporary file. Commands are
+-- reported in the order they appear in ##cmds##, whatever order they
+-- finish in, by calling the procedure ##report_id## with the index of the
+-- command, its exit status and its output.
+--
+-- After the first command that fails, no more commands are started and
+-- the ones still running are killed.
+--
+-- Returns:
+--   The index of the first command that failed, or 0 if they all succeeded.
+
+export function run_jobs(sequence cmds, integer jobs, integer report_id)
+	sequence
+		running = {},  -- { index into cmds, process }
+		status = repeat(-1, length(cmds)),
+		logs = repeat("", length(cmds))
+	integer started = 0, reported = 0, failed = 0, finished
+
+	while reported < length(cmds) do
+		while not failed and started < length(cmds) and length(running) < jobs do
+			started += 1
+			logs[started] = temp_file(, "euc", "log")
+			object p = start_job(cmds[started], logs[started])
+			if atom(p) then
+				status[started] = 127  -- as the shell does for a missing command
+			else
+				running = append(running, { started, p })
+			end if
+		end while
+
+		finished = 0
+		for i = length(running) to 1 by -1 do
+			atom st = pipeio:wait(running[i][2], 0)
+			if st = -2 then
+				-- it can't be waited on, so it will never be seen to finish
+				st = 127
+			end if
+			if st != -1 then
+				status[running[i][1]] = st
+				end_job(running[i][2])
+				running = remove(running, i)
+				finished = 1
+			end if
+		end for
+
+		while reported < started and status[reported + 1] != -1 do
+			reported += 1
+			object output = read_file(logs[reported])
+			delete_file(logs[reported])
+			if atom(output) then
+				output = ""
+			end if
+			call_proc(report_id, { reported, status[reported], output })
+
+			if status[reported] != 0 and not failed then
+				failed = reported
+				for i = 1 to length(running) do
+					pipeio:kill(running[i][2])
+					pipeio:wait(running[i][2])
+					delete_file(logs[running[i][1]])
+				end for
+				running = {}
+			end if
+		end while
+
+		if failed then
+			exit
+		end if
+
+		if not finished then
+			sleep(0.01)
+		end if
+	end while
+
+	return failed
+end function
@@ -12,6 +12,8 @@ include std/regex.e as regex
 include std/text.e
 include std/hash.e
 include std/search.e as search
+include std/sequence.e
+include std/sort.e
 include std/utils.e
 include c_decl.e
 include c_out.e
@@ -21,6 +23,8 @@ include platform.e
 include reswords.e
 include msgtext.e
 include std/math.e as math
+include buildjobs.e
+include objcache.e
 
 constant
 	re_include = regex:new(`^[ ]*(public)*[ \t]*include[ \t]+([A-Za-z0-9_/.]+)`),
@@ -195,6 +199,38 @@ export sequence extra_lflags = ""
 
 export integer force_build = 0
 
+--**
+-- Number of compiler processes the direct build runs at once, 0 for one per processor
+
+export integer max_jobs = 0
+
+--**
+-- Optimize across the C files and the runtime library at link time (GCC only)
+
+export integer lto_option = 0
+
+--**
+-- Profile guided optimization steps
+
+export enum
+	--** no profile guided optimization
+	PGO_NONE = 0,
+	--** build a program that records a profile when it runs
+	PGO_GEN,
+	--** build using the recorded profile
+	PGO_USE
+
+--**
+-- Profile guided optimization step, one of the PGO_ constants (GCC only)
+
+export integer pgo_option = PGO_NONE
+
+--**
+-- Number of "with parallel" loops translated to OpenMP loops. The program
+-- is compiled and linked with OpenMP when there are any.
+
+export integer openmp_loops = 0
+
 --**
 -- Output directory was a system generated name, remove when done
 
@@ -220,6 +256,54 @@ export procedure write_checksum( integer file )
 	cfile_check = 0
 end procedure
 
+-- generated files are written under this suffix until commit_generated_files()
+constant NEW_FILE_EXT = ".new"
+
+-- set by commit_generated_files() when a generated header has changed
+integer headers_changed = 1
+
+--**
+-- Opens the generated file ##name## in the output directory. The file is
+-- written under a temporary name until [[:commit_generated_files]] is called.
+export function open_generated(sequence name, sequence mode = "w")
+	return open(output_dir & name & NEW_FILE_EXT, mode)
+end function
+
+--**
+-- Moves the files written by this translation into place. A file that is
+-- identical to the one left by the previous translation is not rewritten,
+-- so it keeps its timestamp and its object file stays up to date.
+--
+-- The checksums written by [[:write_checksum]] do not depend on the order of
+-- the statements, so files that look the same are compared in full.
+export procedure commit_generated_files()
+	headers_changed = 0
+	for i = 1 to length(generated_files) do
+		sequence name = output_dir & generated_files[i]
+		if not file_exists(name & NEW_FILE_EXT) then
+			continue
+		end if
+
+		integer changed = 1
+		if file_length(name) = file_length(name & NEW_FILE_EXT) then
+			changed = not equal(read_file(name), read_file(name & NEW_FILE_EXT))
+		end if
+
+		if changed then
+			move_file(name & NEW_FILE_EXT, name, 1)
+			if equal(fileext(name), "h") then
+				headers_changed = 1
+			end if
+		else
+			delete_file(name & NEW_FILE_EXT)
+		end if
+
+		if build_system_type = BUILD_DIRECT then
+			outdated_files[i] = changed
+		end if
+	end for
+end procedure
+
 -- searches for the file name needle in a list of files
 -- returned by dir().  First a case-sensitive search and
 -- then a case-insensitive search.  To handle the case when
@@ -318,7 +402,7 @@ export function adjust_for_command_line_passing(sequence long_path)
 		return long_path
 	elsifdef WINDOWS then
 		long_path = regex:find_replace(quote_pattern, long_path, "")
-		sequence longs = split( slash_pattern, long_path )
+		sequence longs = regex:split( slash_pattern, long_path )
 		if length(longs)=0 then
 			return long_path
 		end if
@@ -363,6 +447,28 @@ function adjust_for_build_file(sequence long_path)
 	end if
 end function
 
+--**
+-- With -lto the link step does the optimizing, so it needs the same code
+-- generation options as the compile step. Picks those out of ##c_flags##.
+
+function lto_link_flags(sequence c_flags, sequence l_flags)
+	sequence flags = " -flto"
+	sequence opts = stdseq:split(c_flags, ' ', 1)
+
+	for i = 1 to length(opts) do
+		sequence opt = opts[i]
+		if length(opt) < 2 or opt[1] != '-' or not find(opt[2], "Ofmg") then
+			continue
+		end if
+		if equal(opt, "-flto") or match(" " & opt & " ", l_flags & " ") then
+			continue
+		end if
+		flags &= " " & opt
+	end for
+
+	return flags
+end function
+
 --**
 -- Setup the build environment. This includes things such as the
 -- compiler/linker executable, c flags, linker flags, debug settings,
@@ -513,6 +619,22 @@ function setup_build()
 				c_flags &= " -mno-cygwin"
 			end if
 
+			if lto_option then
+				c_flags &= " -flto"
+			end if
+
+			if openmp_loops then
+				c_flags &= " -fopenmp"
+			end if
+
+			switch pgo_option do
+				case PGO_GEN then
+					c_flags &= " -fprofile-generate"
+				case PGO_USE then
+					-- the profile may have come from a multithreaded run
+					c_flags &= " -fprofile-use -fprofile-correction"
+			end switch
+
 			if build_system_type != BUILD_DIRECT then
 				l_flags = sprintf( " $(RUNTIME_LIBRARY) %s", { m_flag })
 			else
@@ -541,6 +663,17 @@ function setup_build()
 					l_flags &= " -mwindows"
 				end if
 			end if
+
+			if openmp_loops then
+				l_flags &= " -fopenmp"
+			end if
+
+			switch pgo_option do
+				case PGO_GEN then
+					l_flags &= " -fprofile-generate"
+				case PGO_USE then
+					l_flags &= " -fprofile-use"
+			end switch
 			
 			-- input/output
 			rc_comp = compiler_prefix & "windres -DSRCDIR=\"" & adjust_for_build_file(current_dir()) & "\" [1] -O coff -o [2]"
@@ -599,6 +732,10 @@ function setup_build()
 		l_flags &= " " & extra_lflags
 	end if
 
+	if lto_option and compiler_type = COMPILER_GCC then
+		l_flags &= lto_link_flags(c_flags, l_flags)
+	end if
+
 	return { 
 		c_exe, c_flags, l_exe, l_flags, obj_ext, exe_ext, l_flags_begin, rc_comp, user_library
 	}
@@ -813,6 +950,79 @@ procedure write_makefile_partial()
 	close(fh)
 end procedure
 
+--**
+-- Returns the number of compiler processes the direct build runs at once
+
+export function build_jobs()
+	if max_jobs > 0 then
+		return max_jobs
+	end if
+	return cpu_count()
+end function
+
+-- generated_files index, command line and object cache key of each file
+-- build_direct() compiles
+sequence compile_files = {}, compile_cmds = {}, compile_keys = {}
+
+-- C files build_direct() has reported on, and how many there are
+integer files_shown = 0, files_to_show = 0
+
+-- percentage of the C files build_direct() has reported on
+function progress()
+	files_shown += 1
+	return 100 * (files_shown / files_to_show)
+end function
+
+procedure show_compiling(integer file, sequence cmd)
+	if not silent then
+		atom pdone = progress()
+		if not verbose then
+			ShowMsg(1, COMPILING_130_2, { pdone, generated_files[file] })
+		else
+			ShowMsg(1, COMPILING_130_2, { pdone, cmd })
+		end if
+	end if
+end procedure
+
+-- called by run_jobs() for each compile, in file order
+procedure report_compile(integer job, atom status, sequence output)
+	show_compiling(compile_files[job], compile_cmds[job])
+	puts(2, output)
+	if status != 0 then
+		ShowMsg(2, COULDNT_COMPILE_FILE_1, { generated_files[compile_files[job]] })
+		ShowMsg(2, STATUS_1_COMMAND_2, { status, compile_cmds[job] })
+	else
+		cache_put(compile_keys[job], generated_files[compile_files[job] + 1])
+	end if
+end procedure
+
+-- What the objects of a -keep build were compiled with: the compiler command,
+-- and the size and time of the runtime headers and the runtime library, so
+-- that installing another Euphoria rebuilds them too.
+function build_stamp(sequence settings)
+	sequence stamp = settings[SETUP_CEXE] & " " & settings[SETUP_CFLAGS] & "\n"
+	sequence files = {}
+
+	object headers = dir(join_path({ get_eucompiledir(), "include", "*.h" }))
+	if sequence(headers) then
+		headers = sort(headers)
+		for i = 1 to length(headers) do
+			files = append(files, join_path({ get_eucompiledir(), "include", headers[i][D_NAME] }))
+		end for
+	end if
+	files = append(files, settings[SETUP_RUNTIME_LIBRARY])
+
+	for i = 1 to length(files) do
+		object info = dir(files[i])
+		if sequence(info) and length(info) = 1 then
+			stamp &= sprintf("%s %d %04d-%02d-%02d %02d:%02d:%02d\n",
+				{ files[i], info[1][D_SIZE] } & info[1][D_YEAR..D_SECOND])
+		end if
+	end for
+
+	return stamp
+end function
+
 --**
 -- Build the translated code directly from this process
 
@@ -845,9 +1055,40 @@ export procedure build_direct(integer link_only=0, sequence the_file0="")
 		chdir(output_dir)
 	end if
 
-	sequence link_files = {}
+	sequence link_files = {}, stamp = ""
 
 	if not link_only then
+		-- objects from a previous -keep build can be reused when neither
+		-- their C file, the shared header, the compiler flags nor the
+		-- runtime changed
+		sequence cflags = settings[SETUP_CEXE] & " " & settings[SETUP_CFLAGS]
+		stamp = build_stamp(settings)
+		integer rebuild_all = force_build or headers_changed or
+			not equal(read_file(file0 & ".cflags"), stamp)
+		-- written again once everything has compiled
+		delete_file(file0 & ".cflags")
+
+		-- Objects compiled by other builds can be used too, except when they
+		-- depend on more than the compiler is given: on profile data, or on
+		-- the build directory written into the debug information.
+		integer use_cache = length(obj_cache_dir) and pgo_option = PGO_NONE
+		sequence cache_salt_text = ""
+		if use_cache then
+			cache_salt_text = cflags
+			if debug_option then
+				cache_salt_text &= 0 & current_dir()
+			end if
+			cache_salt_text = cache_salt(cache_salt_text, "main-.h", get_eucompiledir())
+		end if
+
+		compile_files = {}
+		compile_cmds = {}
+		compile_keys = {}
+		files_shown = 0
+		files_to_show = 0
+		for i = 1 to length(generated_files) do
+			files_to_show += generated_files[i][$] = 'c'
+		end for
 		for i = 1 to length(generated_files) do
 			if generated_files[i][$] = 'c' then
 				cmd = sprintf("%s %s %s", { settings[SETUP_CEXE], settings[SETUP_CFLAGS],
@@ -855,33 +1096,75 @@ export procedure build_direct(integer link_only=0, sequence the_file0="")
 
 				link_files = append(link_files, generated_files[i])
 
-				if not silent then
-					atom pdone = 100 * (i / length(generated_files))
-					if not verbose then
-						-- disabled until ticket:59 can be fixed
-						-- results in longer build times, but output is correct
-						if 0 and outdated_files[i] = 0 and force_build = 0 then
-							ShowMsg(1, SKIPPING__130_2_UPTODATE, { pdone, generated_files[i] })
-							continue
-						else
-							ShowMsg(1, COMPILING_130_2, { pdone, generated_files[i] })
-						end if
-					else
-						ShowMsg(1, COMPILING_130_2, { pdone, cmd })
+				if not rebuild_all and outdated_files[i] = 0 and
+					not is_file_newer(generated_files[i], generated_files[i + 1])
+				then
+					atom pdone = progress()
+					if not silent and not verbose then
+						ShowMsg(1, SKIPPING__130_2_UPTODATE, { pdone, generated_files[i] })
 					end if
-
+					continue
 				end if
 
-				status = system_exec(cmd, 0)
-				if status != 0 then
-					ShowMsg(2, COULDNT_COMPILE_FILE_1, { generated_files[i] })
-					ShowMsg(2, STATUS_1_COMMAND_2, { status, cmd })
-					goto "build_direct_cleanup"
+				object key = 0
+				if use_cache then
+					key = cache_key(generated_files[i], cache_salt_text)
+					if cache_fetch(key, generated_files[i + 1]) then
+						atom pdone = progress()
+						if not silent then
+							ShowMsg(1, CACHED_130_2, { pdone, generated_files[i] })
+						end if
+						continue
+					end if
 				end if
+
+				compile_files &= i
+				compile_cmds = append(compile_cmds, cmd)
+				compile_keys = append(compile_keys, key)
 			elsif match(".o", generated_files[i]) then
 				objs &= " " & generated_files[i]
 			end if
 		end for
+
+		integer jobs = build_jobs()
+		if jobs > 1 and length(compile_cmds) > jobs then
+			-- start the biggest files first, so that no big file is left
+			-- compiling on its own at the end
+			sequence order = repeat(0, length(compile_files))
+			for i = 1 to length(compile_files) do
+				order[i] = { -file_length(generated_files[compile_files[i]]), i }
+			end for
+			order = sort(order)
+			for i = 1 to length(order) do
+				order[i] = order[i][2]
+			end for
+			compile_files = extract(compile_files, order)
+			compile_cmds = extract(compile_cmds, order)
+			compile_keys = extract(compile_keys, order)
+		end if
+
+		if jobs = 1 or length(compile_cmds) < 2 then
+			for i = 1 to length(compile_cmds) do
+				show_compiling(compile_files[i], compile_cmds[i])
+				status = system_exec(compile_cmds[i], 0)
+				if status != 0 then
+					ShowMsg(2, COULDNT_COMPILE_FILE_1, { generated_files[compile_files[i]] })
+					ShowMsg(2, STATUS_1_COMMAND_2, { status, compile_cmds[i] })
+					goto "build_direct_cleanup"
+				end if
+				cache_put(compile_keys[i], generated_files[compile_files[i] + 1])
+			end for
+		elsif run_jobs(compile_cmds, jobs, routine_id("report_compile")) then
+			goto "build_direct_cleanup"
+		end if
+
+		if use_cache then
+			sequence stats = cache_finish()
+			if not silent then
+				ShowMsg(1, OBJECT_CACHE_12_HITS_34_MISSES_5_MB, { cache_hits, cache_misses,
+					stats[1], stats[2], floor(stats[3] / (1024 * 1024)) })
+			end if
+		end if
 	else
 		object files = read_lines(file0 & ".bld")
 		for i = 1 to length(files) do
@@ -891,9 +1174,11 @@ export procedure build_direct(integer link_only=0, sequence the_file0="")
 
 	if keep and not link_only and length(link_files) then
 		write_lines(file0 & ".bld", link_files)
+		write_file(file0 & ".cflags", stamp)
 	elsif keep = 0 then
-		-- Delete a .bld file that may be left over from a previous -keep invocation
+		-- Delete files that may be left over from a previous -keep invocation
 		delete_file(file0 & ".bld")
+		delete_file(file0 & ".cflags")
 	end if
 
 	-- For MinGW the RC file gets compiled to a .res file and then put in the normal link line
@@ -16,6 +16,7 @@ include euphoria/info.e
 
 include std/datetime.e
 include std/filesys.e
+include std/map.e as map
 include std/math.e
 include std/os.e
 include std/text.e
@@ -658,14 +659,24 @@ export procedure CName(symtab_index s)
 end procedure
 with warning
 
+-- C statements written in every pass, used to measure routines
+integer stmt_count = 0
+
+-- estimated compile cost of the routines in the current C file, and the
+-- cost a C file is allowed to grow to
+integer cfile_cost = 0, cfile_target = 0
+
 --**
 -- output a C statement with replacements for @ or @1 @2 @3, ... @9
 export procedure c_stmt(sequence stmt, object arg, symtab_index lhs_arg = 0)
 	integer argcount, i
 	
-	if LAST_PASS = TRUE and Initializing = FALSE then
-		cfile_size += 1
-		update_checksum( stmt )
+	if Initializing = FALSE then
+		stmt_count += 1
+		if LAST_PASS = TRUE then
+			cfile_size += 1
+			update_checksum( stmt )
+		end if
 	end if
 
 	
@@ -1043,6 +1054,132 @@ procedure declare_prototype( symtab_index s )
 	c_hputs(");\n")
 end procedure
 
+-- FNV-1a hash of name started from seed, as name_hash() in be_runtime.c
+function name_hash(sequence name, atom seed)
+	atom h = seed
+
+	if h = 0 then
+		h = 2166136261
+	end if
+	for i = 1 to length(name) do
+		h = xor_bits(h, name[i])
+		if h < 0 then
+			h += #100000000
+		end if
+		-- h * 16777619 mod 2^32, without going past the 53 bits of an atom
+		h = remainder(h * 403 + and_bits(h, #FF) * #1000000, #100000000)
+	end for
+	return h
+end function
+
+--**
+-- Declare a perfect hash table, for CRoutineId(), of the names of the
+-- entries in a routine or namespace list
+procedure DeclareNameHash(sequence table, sequence names)
+	sequence keys = {}, first = {}, next = repeat(-1, length(names))
+	sequence last = {}, buckets, disp, slots, placed
+	integer size, k, longest = 0
+	atom seed
+	map:map key_index = map:new()
+
+	-- chain entries with the same name, in list order
+	for i = 1 to length(names) do
+		k = map:get(key_index, names[i], 0)
+		if k then
+			next[last[k]] = i - 1
+			last[k] = i
+		else
+			keys = append(keys, names[i])
+			first &= i - 1
+			last &= i
+			map:put(key_index, names[i], length(keys))
+		end if
+	end for
+
+	size = length(keys)
+	buckets = repeat({}, size)
+	disp = repeat(0, size)
+	slots = repeat(0, size)
+	for i = 1 to size do
+		k = remainder(name_hash(keys[i], 0), size) + 1
+		buckets[k] &= i
+		if length(buckets[k]) > longest then
+			longest = length(buckets[k])
+		end if
+	end for
+
+	-- find a seed for each bucket that sends its names to free slots,
+	-- biggest buckets first while most slots are still free
+	for n = longest to 2 by -1 do
+		for b = 1 to size do
+			if length(buckets[b]) = n then
+				seed = 1
+				while TRUE do
+					placed = {}
+					for i = 1 to n do
+						k = remainder(name_hash(keys[buckets[b][i]], seed), size) + 1
+						if slots[k] or find(k, placed) then
+							exit
+						end if
+						placed &= k
+					end for
+					if length(placed) = n then
+						exit
+					end if
+					seed += 1
+				end while
+				disp[b] = seed
+				for i = 1 to n do
+					slots[placed[i]] = buckets[b][i]
+				end for
+			end if
+		end for
+	end for
+
+	-- lone names take any free slot
+	k = 1
+	for b = 1 to size do
+		if length(buckets[b]) = 1 then
+			while slots[k] do
+				k += 1
+			end while
+			slots[k] = buckets[b][1]
+			disp[b] = -k
+		end if
+	end for
+
+	c_hputs(sprintf("extern struct name_hash %s;\n", { table }))
+	c_printf("int %sd[] = {", { table })
+	if size = 0 then
+		c_puts("0")
+	end if
+	for i = 1 to size do
+		if i > 1 then
+			c_puts(", ")
+		end if
+		c_printf("%d", disp[i])
+	end for
+	c_printf("};\nint %sf[] = {", { table })
+	if size = 0 then
+		c_puts("0")
+	end if
+	for i = 1 to size do
+		if i > 1 then
+			c_puts(", ")
+		end if
+		c_printf("%d", first[slots[i]])
+	end for
+	c_printf("};\nint %sn[] = {", { table })
+	for i = 1 to length(next) do
+		c_printf("%d, ", next[i])
+	end for
+	c_puts("-1};\n")
+	c_printf("struct name_hash %s = { %d, ", { table, size })
+	c_printf("%sd, ", { table })
+	c_printf("%sf, ", { table })
+	c_printf("%sn };\n\n", { table })
+end procedure
+
 procedure add_to_routine_list( symtab_index s, integer seq_num, integer first )
 	if not first then
 		c_puts(",\n")
@@ -1089,6 +1226,7 @@ end procedure
 export procedure DeclareRoutineList()
 	symtab_index s
 	integer first, seq_num
+	sequence names = {}
 
 	c_hputs("extern struct routine_list _00[];\n")
 	
@@ -1119,6 +1257,7 @@ export procedure DeclareRoutineList()
 				
 				add_to_routine_list( s, seq_num, first )
 				first = FALSE
+				names = append(names, SymTab[s][S_NAME])
 				
 			end if
 			seq_num += 1
@@ -1129,6 +1268,10 @@ export procedure DeclareRoutineList()
 	end if
 	c_puts("  {\"\", 0, 999999999, 0, 0, 0, 0}\n};\n\n")  -- end marker
 
+	if emit_c_output then
+		DeclareNameHash("_03", names)
+	end if
+
 	c_hputs("extern char ** _02;\n")
 	c_puts("char ** _02;\n")
 
@@ -1141,6 +1284,7 @@ end procedure
 export procedure DeclareNameSpaceList()
 	symtab_index s
 	integer first, seq_num
+	sequence names = {}
 
 	c_hputs("extern struct ns_list _01[];\n")
 	c_puts("struct ns_list _01[] = {\n")
@@ -1164,6 +1308,7 @@ export procedure DeclareNameSpaceList()
 				c_printf(", %d", SymTab[s][S_FILE_NO])
 
 				c_puts("}")
+				names = append(names, SymTab[s][S_NAME])
 			end if
 			seq_num += 1
 		end if
@@ -1173,6 +1318,10 @@ export procedure DeclareNameSpaceList()
 		c_puts(",\n")
 	end if
 	c_puts("  {\"\", 0, 999999999, 0}\n};\n\n")  -- end marker
+
+	if emit_c_output then
+		DeclareNameHash("_04", names)
+	end if
 end procedure
 
 --**
@@ -1233,6 +1382,7 @@ end procedure
 -- end the old .c file and start a new one
 export procedure new_c_file(sequence name)
 	cfile_size = 0
+	cfile_cost = 0
 
 
 	if LAST_PASS = FALSE then
@@ -1242,7 +1392,7 @@ export procedure new_c_file(sequence name)
 	write_checksum( c_code )
 	close(c_code)
 
-	c_code = open(output_dir & name & ".c", "w")
+	c_code = open_generated(name & ".c")
 	if c_code = -1 then
 		CompileErr(COULDNT_OPEN_C_FILE_FOR_OUTPUT)
 	end if
@@ -1344,7 +1494,8 @@ export procedure add_file(sequence filename, sequence eu_filename = "")
 	generated_files = append(generated_files, src_fname)
 	generated_files = append(generated_files, obj_fname)
 	if build_system_type = BUILD_DIRECT then
-		outdated_files  = append(outdated_files, is_file_newer(eu_filename, output_dir & src_fname))
+		-- until commit_generated_files() finds the C file unchanged
+		outdated_files  = append(outdated_files, 1)
 		outdated_files  = append(outdated_files, 0)
 	end if
 end procedure
@@ -1469,6 +1620,61 @@ end function
 -- walk through the user-defined routines, computing types and
 -- optionally generating code
 sequence file_routines = {}
+
+-- C statements each routine took in the previous pass, by symbol
+sequence routine_stmts = {}
+
+function routine_cost(symtab_index s)
+-- Estimates how long the C compiler will take over routine s. The optimizer
+-- takes more than linear time in the size of a function, so a routine twice
+-- as big costs more than twice as much.
+	atom n = 0
+	if s <= length(routine_stmts) then
+		n = routine_stmts[s]
+	end if
+	if n = 0 and sequence(SymTab[s][S_CODE]) then
+		-- not measured yet: about 1 line of C per element of CODE
+		n = length(SymTab[s][S_CODE])
+	end if
+	if max_cfile_size > 0 then
+		n += floor(n * n / max_cfile_size)
+	end if
+	return n
+end function
+
+-- compiler processes split_target() plans for when the C files are built
+-- elsewhere, so that the files don't depend on the translating machine
+constant SPLIT_JOBS = 8
+
+function split_target()
+-- The cost to fill each C file up to, so that there are about two files per
+-- compiler process, which gives the parallel build room to balance them.
+-- The limits keep the headers every file includes from dominating, and
+-- -maxsize still caps the size.
+	atom total = 0
+	for f = 1 to length(file_routines) do
+		for r = 1 to length(file_routines[f]) do
+			if SymTab[file_routines[f][r]][S_USAGE] != U_DELETED then
+				total += routine_cost(file_routines[f][r])
+			end if
+		end for
+	end for
+
+	integer jobs = SPLIT_JOBS
+	if max_jobs > 0 or build_system_type = BUILD_DIRECT then
+		jobs = build_jobs()
+	end if
+
+	atom target = floor(total / (2 * jobs))
+	if target < max_cfile_size / 20 then
+		target = floor(max_cfile_size / 20)
+	end if
+	if target > max_cfile_size then
+		target = max_cfile_size
+	end if
+	return target
+end function
+
 procedure check_file_routines()
 	if not length( file_routines ) then
 		file_routines = repeat( {}, length( known_files ) )
@@ -1503,6 +1709,12 @@ export procedure GenerateUserRoutines()
 	end if
 	
 	check_file_routines()
+	if LAST_PASS = TRUE then
+		cfile_target = split_target()
+	end if
+	if length(routine_stmts) < length(SymTab) then
+		routine_stmts &= repeat(0, length(SymTab) - length(routine_stmts))
+	end if
 		
 	c_puts("// GenerateUserRoutines\n")
 	for file_no = 1 to length(known_files) do
@@ -1555,14 +1767,16 @@ export procedure GenerateUserRoutines()
 				if SymTab[s][S_USAGE] != U_DELETED then
 					-- a referenced routine in this file
 
-					-- Check for oversize C file
+					-- Check for oversize C file. A routine that would take the
+					-- file past its target starts a new one, so big routines
+					-- end up on their own and compile alongside the rest.
+					integer cost = routine_cost(s)
 					if LAST_PASS = TRUE and
 						(cfile_size > max_cfile_size or
-						(s != TopLevelSub and cfile_size > max_cfile_size/4 and
-						length(SymTab[s][S_CODE]) > max_cfile_size))
+						(s != TopLevelSub and cfile_cost > cfile_target/8 and
+						cfile_cost + cost > cfile_target))
 					then
 						-- start a new C file
-						-- (we generate about 1 line of C per element of CODE)
 
 						-- choose new file name, based on base_name
 						if length(c_file) = 7 then
@@ -1742,7 +1956,10 @@ export procedure GenerateUserRoutines()
 					end for
 
 					-- walk through the IL for this routine
+					integer first_stmt = stmt_count
 					call_proc(Execute_id, {s})
+					routine_stmts[s] = stmt_count - first_stmt
+					cfile_cost += cost
 
 					c_puts("    ;\n}\n")
 					if dll_option and is_exported( s ) then
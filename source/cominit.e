@@ -414,7 +414,7 @@ end function
 -- Process options that are common to the Interpreter and Translator.
 
 export procedure handle_common_options(m:map opts)
-	sequence opt_keys = m:keys(opts)
+	sequence opt_keys = m:keys(opts, 1)
 	integer option_w = 0
 
 	for idx = 1 to length(opt_keys) do
@@ -550,7 +550,7 @@ export procedure finalize_command_line(m:map opts)
 	-- from the command line
 	sequence extras = m:get(opts, cmdline:EXTRAS)
 	if length(extras) > 0 then
-		sequence pairs = m:pairs( opts )
+		sequence pairs = m:pairs( opts, 1 )
 		
 		for i = 1 to length( pairs ) do
 			sequence pair = pairs[i]
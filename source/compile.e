@@ -234,7 +234,7 @@ end procedure
 -- Calls [:dispose_temp] for all temps that have been queued, but not yet
 -- disposed with the specified keep value.
 procedure dispose_all_temps( integer keep, integer remove_from_map, integer except = 0 )
-	sequence syms = map:keys( dead_temp_walking )
+	sequence syms = map:keys( dead_temp_walking, 1 )
 	for i = 1 to length( syms ) do
 		if except = syms[i] then
 			continue
@@ -401,6 +401,33 @@ function SeqElem(integer x)
 	return local_t
 end function
 
+function SliceElem(integer x)
+-- the type of the elements that var[i..j] = x stores
+	if TypeIs(x, TYPE_SEQUENCE) then
+		return SeqElem(x)
+	elsif TypeIsIn(x, TYPES_IAD) then
+		return GType(x)
+	else
+		return TYPE_OBJECT
+	end if
+end function
+
+procedure SetBBTypeKeepElem(integer x)
+-- forget the local element type of var x, whose elements are about to be
+-- replaced by an op= assignment. The ASSIGN_SUBS or ASSIGN_SLICE that
+-- completes the assignment records the new element type, so the global
+-- element type and length of x are left as they were.
+	integer elem_new = SymTab[x][S_SEQ_ELEM_NEW]
+	atom len_new = SymTab[x][S_SEQ_LEN_NEW]
+
+	target[MIN] = -1
+	SetBBType(x, TYPE_SEQUENCE, target, TYPE_OBJECT, HasDelete( x ) )
+	if SymTab[x][S_MODE] = M_NORMAL then
+		SymTab[x][S_SEQ_ELEM_NEW] = elem_new
+		SymTab[x][S_SEQ_LEN_NEW] = len_new
+	end if
+end procedure
+
 function SeqLen(integer x)
 -- the length of a sequence
 	symtab_index s
@@ -1666,6 +1693,33 @@ type realshort(integer i)
     return abs(i) < 20_000
 end type
 
+function IntegerSumRange(integer op, integer left, integer right)
+-- the range of left + right or left - right, where both are integers,
+-- or {NOVALUE, NOVALUE} if the result might not be an integer on the target
+	sequence left_val, right_val, result
+
+	left_val = ObjMinMax(left)
+	right_val = ObjMinMax(right)
+
+	if left_val[MIN] = NOVALUE or right_val[MIN] = NOVALUE then
+		return {NOVALUE, NOVALUE}
+	end if
+
+	if op = PLUS or op = PLUS_I then
+		result = {left_val[MIN] + right_val[MIN], left_val[MAX] + right_val[MAX]}
+	else
+		result = {left_val[MIN] - right_val[MAX], left_val[MAX] - right_val[MIN]}
+	end if
+
+	-- keep clear of the limits, where the ranges of 64-bit targets
+	-- can no longer be computed exactly with doubles
+	if result[MIN] < TMININT / 2 or result[MAX] > TMAXINT / 2 then
+		return {NOVALUE, NOVALUE}
+	end if
+
+	return result
+end function
+
 function IntegerMultiply(integer a, integer b)
 -- create the optimal code for multiplying two integers,
 -- based on their min and max values.
@@ -2092,17 +2146,25 @@ function binary_op(integer pc, integer ResAlwaysInt, sequence target_val,
 			end if
 		end if
 
+		sequence sum_range = {NOVALUE, NOVALUE}
+		if find(Code[pc], {PLUS, PLUS_I, MINUS, MINUS_I}) then
+			sum_range = IntegerSumRange(Code[pc], rhs1, rhs2)
+		end if
+
 		c_stmt(intcode, {lhs, rhs1, rhs2}, lhs)
 
 		if ResAlwaysInt then
 			-- int operands => int result
 			SetBBType(lhs, TYPE_INTEGER, target_val, TYPE_OBJECT, 0)
+		elsif sum_range[MIN] != NOVALUE then
+			-- the ranges of the operands rule out an overflow
+			SetBBType(lhs, TYPE_INTEGER, sum_range, TYPE_OBJECT, 0)
 		else
 			SetBBType(lhs, TYPE_ATOM, novalue, TYPE_OBJECT, 0 )
 		end if
 
 		-- now that Code[pc+3]'s type and value have been updated:
-		if find(Code[pc], {PLUS, PLUS_I, MINUS, MINUS_I}) then
+		if sum_range[MIN] = NOVALUE and find(Code[pc], {PLUS, PLUS_I, MINUS, MINUS_I}) then
 			c_stmt(intcode_extra, {lhs, rhs1, rhs2}, lhs)
 		end if
 
@@ -2327,6 +2389,57 @@ procedure arg_list(integer i)
 	indent -= 20
 end procedure
 
+-- constants initialized by routine_id("name"), mapped to the routine
+-- that the name was found to refer to at compile time
+map:map routine_id_constants = map:new()
+
+-- { argument sequence temp, { its elements } } when the sequence built by
+-- the last RIGHT_BRACE op was left out, because the CALL_PROC / CALL_FUNC
+-- after it calls its routine directly
+sequence deferred_args = { 0, {} }
+
+function direct_call_target( integer call_pc, integer nargs )
+-- Returns the routine called by the CALL_PROC / CALL_FUNC at call_pc, if its
+-- routine id is known at compile time and it takes nargs arguments, else 0.
+	symtab_index sub
+
+	if not find( Code[call_pc], { CALL_PROC, CALL_FUNC } ) then
+		return 0
+	end if
+
+	sub = map:get( routine_id_constants, Code[call_pc+1], 0 )
+	if sub = 0 or SymTab[sub][S_NUM_ARGS] != nargs then
+		return 0
+	end if
+
+	-- leave call_proc() of a function and the like to the run time checks
+	if (Code[call_pc] = CALL_FUNC) != (SymTab[sub][S_TOKEN] != PROC) then
+		return 0
+	end if
+
+	return sub
+end function
+
+function defer_args( integer call_pc, symtab_index seq, sequence elements )
+-- Called by the RIGHT_BRACE ops. Returns TRUE if the sequence seq with
+-- the given elements doesn't have to be built, because it is only used
+-- as the arguments of a direct call at call_pc.
+	if Code[call_pc+2] != seq or not is_temp( seq ) or
+	   not direct_call_target( call_pc, length( elements ) ) then
+		return FALSE
+	end if
+
+	-- a temp can only be handed over to the routine once
+	for i = 1 to length( elements ) do
+		if is_temp( elements[i] ) and find( elements[i], elements, i+1 ) then
+			return FALSE
+		end if
+	end for
+
+	deferred_args = { seq, elements }
+	return TRUE
+end function
+
 -- common vars for do_exec ops
 integer n, t, ov
 atom len
@@ -2433,6 +2546,28 @@ procedure opPROC_TAIL()
 	pc += 2 + SymTab[sub][S_NUM_ARGS] + (SymTab[sub][S_TOKEN] != PROC)
 end procedure
 
+procedure SetResultType(symtab_index sub, symtab_index result)
+-- record what is known about the value returned by a call to function sub
+	if SymTab[sub][S_GTYPE] = TYPE_INTEGER then
+		target = {SymTab[sub][S_OBJ_MIN], SymTab[sub][S_OBJ_MAX]}
+		SetBBType(result, SymTab[sub][S_GTYPE], target, TYPE_OBJECT,
+			HasDelete( sub ) )
+
+	elsif SymTab[sub][S_GTYPE] = TYPE_SEQUENCE then
+		target[MIN] = SymTab[sub][S_SEQ_LEN]
+		SetBBType(result, SymTab[sub][S_GTYPE], target,
+						  SymTab[sub][S_SEQ_ELEM],
+						  HasDelete( sub ) )
+
+	else
+		SetBBType(result, SymTab[sub][S_GTYPE], novalue,
+						  SymTab[sub][S_SEQ_ELEM],
+						  HasDelete( sub ) )
+
+	end if
+	SymTab[result][S_ONE_REF] = FALSE
+end procedure
+
 procedure opPROC()
 -- Normal subroutine call
 -- generate code for a procedure/function call
@@ -2547,24 +2682,7 @@ procedure opPROC()
 			create_temp( Code[pc+n-1], 1 )
 		end if
 
-		if SymTab[sub][S_GTYPE] = TYPE_INTEGER then
-			target = {SymTab[sub][S_OBJ_MIN], SymTab[sub][S_OBJ_MAX]}
-			SetBBType(Code[pc+n-1], SymTab[sub][S_GTYPE], target, TYPE_OBJECT,
-				HasDelete( sub ) )
-
-		elsif SymTab[sub][S_GTYPE] = TYPE_SEQUENCE then
-			target[MIN] = SymTab[sub][S_SEQ_LEN]
-			SetBBType(Code[pc+n-1], SymTab[sub][S_GTYPE], target,
-							  SymTab[sub][S_SEQ_ELEM],
-							  HasDelete( sub ) )
-
-		else
-			SetBBType(Code[pc+n-1], SymTab[sub][S_GTYPE], novalue,
-							  SymTab[sub][S_SEQ_ELEM],
-							  HasDelete( sub ) )
-
-		end if
-		SymTab[Code[pc+n-1]][S_ONE_REF] = FALSE
+		SetResultType(sub, Code[pc+n-1])
 	end if
 
 	for i = 1 to length(temps) do
@@ -2608,7 +2726,7 @@ procedure opRHS_SUBS()
 		case ASSIGN_OP_SUBS then
 			c_stmt("_2 = (object)SEQ_PTR(@);\n", Code[pc+1])
 			-- element type of pc[1] is changed
-			SetBBType(Code[pc+1], TYPE_SEQUENCE, novalue, TYPE_OBJECT, 0 )
+			SetBBTypeKeepElem(Code[pc+1])
 		case else
 			c_stmt("_2 = (object)SEQ_PTR(@);\n", Code[pc+1])
 	end switch
@@ -3286,6 +3404,15 @@ end procedure
 procedure opRIGHT_BRACE_N()
 -- form a sequence of any length
 	len = Code[pc+1]+2
+	sequence elements = repeat( 0, Code[pc+1] )
+	for i = 1 to Code[pc+1] do
+		elements[i] = Code[pc+len-i]
+	end for
+	if defer_args( pc + len + 1, Code[pc+len], elements ) then
+		pc += len + 1
+		return
+	end if
+
 	if Code[pc+1] = 0 then
 		CSaveStr("_0", Code[pc+len], 0, 0, 0) -- no need to delay DeRef
 	else
@@ -3342,6 +3469,11 @@ end procedure
 
 procedure opRIGHT_BRACE_2()
 -- form a sequence of length 2
+	if defer_args( pc + 4, Code[pc+3], { Code[pc+2], Code[pc+1] } ) then
+		pc += 4
+		return
+	end if
+
 	for i = pc + 1 to pc + 2 do
 		if not is_temp( Code[i] )
 		or map:get( dead_temp_walking, Code[i], NO_REFERENCE ) = NO_REFERENCE then
@@ -3567,9 +3699,8 @@ procedure opASSIGN_OP_SLICE()
 
 	else
 		c_stmt("assign_slice_seq = (s1_ptr *)&@;\n", Code[pc+1])
-		target[MIN] = -1
-		SetBBType(Code[pc+1], TYPE_SEQUENCE, target, TYPE_OBJECT, HasDelete( Code[pc+1] ) )
-		-- OR-in the element type
+		-- the ASSIGN_SLICE that follows ORs-in the element type
+		SetBBTypeKeepElem(Code[pc+1])
 		c_stmt("RHS_Slice(@, @, @);\n",
 			   {Code[pc+1], Code[pc+2], Code[pc+3]})
 	end if
@@ -3588,14 +3719,16 @@ procedure opASSIGN_SLICE()
 		-- optimization, assumes no call to other Euphoria routine
 		-- between [P]ASSIGN_OP_SLICE and here
 		-- assign_slice_seq has already been set
-		-- adjust etype - handle assign_op_slice too!!!
 	elsif opcode = PASSIGN_SLICE then
 		c_stmt0("assign_slice_seq = (s1_ptr *)_3;\n")
 	else
 		c_stmt("assign_slice_seq = (s1_ptr *)&@;\n", Code[pc+1])
-		target[MIN] = -1
-		SetBBType(Code[pc+1], TYPE_SEQUENCE, target, GType(Code[pc+4]), HasDelete( Code[pc+4] ) )
+	end if
+
+	if opcode = ASSIGN_SLICE and previous_previous_op != PASSIGN_OP_SLICE then
 		-- OR-in the element type
+		target[MIN] = -1
+		SetBBType(Code[pc+1], TYPE_SEQUENCE, target, SliceElem(Code[pc+4]), HasDelete( Code[pc+4] ) )
 	end if
 	c_stmt("AssignSlice(@, @, @);\n", {Code[pc+2], Code[pc+3], Code[pc+4]})
 	dispose_temps( pc+2, 3, DISCARD_TEMP, REMOVE_FROM_MAP )
@@ -4407,6 +4540,284 @@ procedure opSC2_OR()
 	pc += 3
 end procedure
 
+-- parallel for loops
+
+constant
+	PARALLEL_BINOPS = { PLUS, PLUS_I, PLUS1, MINUS, MINUS_I, MULTIPLY, DIVIDE, DIV2 },
+	PARALLEL_UNOPS = { UMINUS, SQRT },
+	PARALLEL_ASSIGN = { ASSIGN_SUBS, ASSIGN_SUBS_CHECK, ASSIGN_SUBS_I },
+	PARALLEL_SKIP = { STARTLINE, NOP1, NOP2, DEREF_TEMP, NOVALUE_TEMP }
+
+function parallel_body(integer for_pc)
+-- Returns the body of the "with parallel" for loop at for_pc as a list of
+-- { op, operands, target }, or 0 if it can't run as an OpenMP loop.
+-- Such a loop goes up by 1 and its body is one assignment to an element
+-- of a sequence at the loop index, computed with arithmetic from elements
+-- of other sequences at the loop index, the index itself and values that
+-- don't change in the loop.
+	symtab_index loop_var = Code[for_pc+5], inc = Code[for_pc+1]
+	integer end_pc = Code[for_pc+6] - 5
+	sequence body = {}, defined = {}, operands
+	integer op, p = for_pc + 7
+
+	if not find(loop_var, parallel_loops) or
+		sym_mode(inc) != M_CONSTANT or not equal(sym_obj(inc), 1) or
+		end_pc <= p or Code[end_pc+3] != loop_var or
+		not find(Code[end_pc], { ENDFOR_INT_UP1, ENDFOR_GENERAL })
+	then
+		return 0
+	end if
+
+	while p < end_pc do
+		op = Code[p]
+		if length(body) and body[$][1] = ASSIGN_SUBS then
+			-- nothing but bookkeeping may follow the assignment
+			if not find(op, PARALLEL_SKIP) then
+				return 0
+			end if
+
+		elsif find(op, ALL_RHS_SUBS) then
+			if Code[p+2] != loop_var or Code[p+1] = loop_var or
+				is_temp(Code[p+1]) or not is_temp(Code[p+3])
+			then
+				return 0
+			end if
+			body = append(body, { RHS_SUBS, { Code[p+1] }, Code[p+3] })
+			defined &= Code[p+3]
+
+		elsif find(op, PARALLEL_BINOPS) or find(op, PARALLEL_UNOPS) then
+			if find(op, PARALLEL_BINOPS) then
+				operands = Code[p+1..p+2]
+			else
+				operands = { Code[p+1] }
+			end if
+			for i = 1 to length(operands) do
+				if is_temp(operands[i]) and not find(operands[i], defined) then
+					return 0
+				end if
+			end for
+			if not is_temp(Code[p+length(operands)+1]) then
+				return 0
+			end if
+			body = append(body, { op, operands, Code[p+length(operands)+1] })
+			defined &= Code[p+length(operands)+1]
+
+		elsif find(op, PARALLEL_ASSIGN) then
+			if Code[p+2] != loop_var or Code[p+1] = loop_var or
+				is_temp(Code[p+1]) or sym_mode(Code[p+1]) = M_CONSTANT or
+				(is_temp(Code[p+3]) and not find(Code[p+3], defined))
+			then
+				return 0
+			end if
+			body = append(body, { ASSIGN_SUBS, { Code[p+3] }, Code[p+1] })
+
+		elsif not find(op, PARALLEL_SKIP) then
+			return 0
+		end if
+		p = advance(p)
+	end while
+
+	if length(body) = 0 or body[$][1] != ASSIGN_SUBS then
+		return 0
+	end if
+	return body
+end function
+
+-- C names of the value and of the is-a-double flag of a parallel loop operand
+function par_names(symtab_index s, symtab_index loop_var)
+	if s = loop_var then
+		return { "(eudouble)_0k", "0" }
+	end if
+	return { sprintf("_0v%d", s), sprintf("_0f%d", s) }
+end function
+
+-- reads the atom in C expression obj into the value and flag of s, or
+-- gives up on the parallel loop if it isn't one
+procedure par_load(sequence obj, symtab_index s, integer in_loop)
+	sequence v = par_names(s, 0)
+
+	c_stmt0(sprintf("if (IS_ATOM_INT(%s)) {\n", { obj }))
+	c_stmt0(sprintf("%s = (eudouble)%s;\n", { v[1], obj }))
+	c_stmt0(sprintf("%s = 0;\n", { v[2] }))
+	c_stmt0("}\n")
+	c_stmt0(sprintf("else if (IS_ATOM(%s)) {\n", { obj }))
+	c_stmt0(sprintf("%s = DBL_PTR(%s)->dbl;\n", { v[1], obj }))
+	c_stmt0(sprintf("%s = 1;\n", { v[2] }))
+	c_stmt0("}\n")
+	if in_loop then
+		c_stmt0("else {\n")
+		c_stmt0("_0bad = 1;\n")
+		c_stmt0("continue;\n")
+		c_stmt0("}\n")
+	else
+		c_stmt0("else\n")
+		c_stmt0("_0bad = 1;\n")
+	end if
+end procedure
+
+procedure ParallelFor(sequence body)
+-- Emits an OpenMP version of the "with parallel" for loop at pc, ahead of
+-- the plain loop. It computes every element first, in parallel, then
+-- stores them, and falls through to the plain loop when the values it
+-- meets are not all atoms or would make the plain loop fail.
+-- The parallel part reads the input sequences and writes to memory of
+-- its own, so it does no reference counting and no allocation.
+	symtab_index loop_var = Code[pc+5], first = Code[pc+3], last = Code[pc+2]
+	symtab_index out = body[$][3]
+	sequence seqs = {}, scalars = {}, temps = {}, a, b, t
+
+	for i = 1 to length(body) do
+		if body[i][1] = RHS_SUBS then
+			if not find(body[i][2][1], seqs) then
+				seqs &= body[i][2][1]
+			end if
+		else
+			for j = 1 to length(body[i][2]) do
+				symtab_index s = body[i][2][j]
+				if not is_temp(s) and s != loop_var and not find(s, scalars) then
+					scalars &= s
+				end if
+			end for
+		end if
+		if body[i][1] != ASSIGN_SUBS and not find(body[i][3], temps) then
+			temps &= body[i][3]
+		end if
+	end for
+
+	c_stmt0("{\n")
+	c_stmt0("intptr_t _0k, _0n;\n")
+	c_stmt0("int _0bad;\n")
+	c_stmt0("eudouble *_0r;\n")
+	c_stmt0("char *_0rf;\n")
+	c_stmt0("s1_ptr _0s;\n")
+	c_stmt0("object _0o;\n")
+	for i = 1 to length(seqs) do
+		c_stmt0(sprintf("object_ptr _0b%d;\n", seqs[i]))
+	end for
+	for i = 1 to length(scalars) do
+		a = par_names(scalars[i], 0)
+		c_stmt0(sprintf("eudouble %s;\n", { a[1] }))
+		c_stmt0(sprintf("int %s;\n", { a[2] }))
+	end for
+
+	c_stmt("_0bad = !IS_ATOM_INT(@1) || !IS_ATOM_INT(@2) || @1 < 1 || @1 > @2;\n",
+		{ first, last })
+	for i = 1 to length(seqs) do
+		c_stmt("if (!_0bad && (!IS_SEQUENCE(@1) || SEQ_PTR(@1)->length < @2))\n",
+			{ seqs[i], last })
+		c_stmt0("_0bad = 1;\n")
+		c_stmt("if (!_0bad)\n", seqs[i])
+		c_stmt(sprintf("_0b%d = SEQ_PTR(@)->base;\n", seqs[i]), seqs[i])
+	end for
+	c_stmt("if (!_0bad && (!IS_SEQUENCE(@1) || SEQ_PTR(@1)->length < @2))\n",
+		{ out, last })
+	c_stmt0("_0bad = 1;\n")
+	for i = 1 to length(scalars) do
+		c_stmt0("if (!_0bad) {\n")
+		c_stmt("_0o = @;\n", scalars[i])
+		par_load("_0o", scalars[i], FALSE)
+		c_stmt0("}\n")
+	end for
+
+	c_stmt0("if (!_0bad) {\n")
+	c_stmt("_0n = @ - @ + 1;\n", { last, first })
+	c_stmt0("_0r = (eudouble *)TransAlloc(_0n * (sizeof(eudouble) + 1));\n")
+	c_stmt0("}\n")
+
+	c_stmt0("if (!_0bad) {\n")
+	c_stmt0("_0rf = (char *)(_0r + _0n);\n")
+	c_stmt0("#pragma omp parallel for reduction(|:_0bad)\n")
+	c_stmt("for (_0k = @1; _0k <= @2; _0k++) {\n", { first, last })
+	c_stmt0("object _0e;\n")
+	for i = 1 to length(temps) do
+		a = par_names(temps[i], 0)
+		c_stmt0(sprintf("eudouble %s;\n", { a[1] }))
+		c_stmt0(sprintf("int %s;\n", { a[2] }))
+	end for
+
+	for i = 1 to length(body) do
+		integer op = body[i][1]
+		a = par_names(body[i][2][1], loop_var)
+		t = par_names(body[i][3], loop_var)
+		if op = RHS_SUBS then
+			c_stmt0(sprintf("_0e = _0b%d[_0k];\n", body[i][2][1]))
+			par_load("_0e", body[i][3], TRUE)
+
+		elsif op = ASSIGN_SUBS then
+			c_stmt(sprintf("_0r[_0k - @] = %s;\n", { a[1] }), first)
+			c_stmt(sprintf("_0rf[_0k - @] = %s;\n", { a[2] }), first)
+
+		elsif op = UMINUS then
+			c_stmt0(sprintf("%s = -%s;\n", { t[1], a[1] }))
+			c_stmt0(sprintf("%s = %s;\n", { t[2], a[2] }))
+
+		elsif op = SQRT then
+			-- as e_sqrt() and De_sqrt()
+			c_stmt0(sprintf("if (%s < 0) {\n", { a[1] }))
+			c_stmt0("_0bad = 1;\n")
+			c_stmt0("continue;\n")
+			c_stmt0("}\n")
+			c_stmt0(sprintf("%s = sqrt((double)%s);\n", { t[1], a[1] }))
+			c_stmt0(sprintf("%s = 1;\n", { t[2] }))
+
+		else
+			b = par_names(body[i][2][2], loop_var)
+			switch op do
+				case PLUS, PLUS_I, PLUS1 then
+					c_stmt0(sprintf("%s = %s + %s;\n", { t[1], a[1], b[1] }))
+				case MINUS, MINUS_I then
+					c_stmt0(sprintf("%s = %s - %s;\n", { t[1], a[1], b[1] }))
+				case MULTIPLY then
+					c_stmt0(sprintf("%s = %s * %s;\n", { t[1], a[1], b[1] }))
+				case else
+					c_stmt0(sprintf("if (%s == 0) {\n", { b[1] }))
+					c_stmt0("_0bad = 1;\n")
+					c_stmt0("continue;\n")
+					c_stmt0("}\n")
+					c_stmt0(sprintf("%s = %s / %s;\n", { t[1], a[1], b[1] }))
+			end switch
+			c_stmt0(sprintf("%s = %s | %s;\n", { t[2], a[2], b[2] }))
+		end if
+
+		if op != RHS_SUBS and op != ASSIGN_SUBS and op != SQRT then
+			-- integer results that don't fit, or don't divide evenly, are
+			-- doubles in Euphoria too
+			c_stmt0(sprintf("if (!%s && (%s < MININT_DBL || %s > MAXINT_DBL || " &
+				"%s != (eudouble)(intptr_t)%s))\n",
+				{ t[2], t[1], t[1], t[1], t[1] }))
+			c_stmt0(sprintf("%s = 1;\n", { t[2] }))
+		end if
+	end for
+	c_stmt0("}\n")
+
+	c_stmt0("if (!_0bad) {\n")
+	c_stmt("_0s = SEQ_PTR(@);\n", out)
+	c_stmt0("if (!UNIQUE(_0s)) {\n")
+	c_stmt0("_0s = (s1_ptr)SequenceCopy(_0s);\n")
+	c_stmt("@ = MAKE_SEQ(_0s);\n", out)
+	c_stmt0("}\n")
+	c_stmt("for (_0k = @1; _0k <= @2; _0k++) {\n", { first, last })
+	c_stmt0("_0o = _0s->base[_0k];\n")
+	c_stmt("if (_0rf[_0k - @])\n", first)
+	c_stmt("_0s->base[_0k] = NewDouble(_0r[_0k - @]);\n", first)
+	c_stmt0("else\n")
+	c_stmt("_0s->base[_0k] = (object)(intptr_t)_0r[_0k - @];\n", first)
+	c_stmt0("DeRef(_0o);\n")
+	c_stmt0("}\n")
+	c_stmt0("}\n")
+	c_stmt0("EFree((char *)_0r);\n")
+	c_stmt0("}\n")
+
+	c_stmt0("if (!_0bad) {\n")
+	Goto(Code[pc+6])
+	c_stmt0("}\n")
+	c_stmt0("}\n")
+
+	if LAST_PASS then
+		openmp_loops += 1
+	end if
+end procedure
+
 -- for loops
 
 procedure opFOR()
@@ -4424,6 +4835,11 @@ procedure opFOR()
 		CRef(Code[pc+3])
 		c_stmt("@ = @;\n", {Code[pc+5], Code[pc+3]})
 
+		object body = parallel_body(pc)
+		if sequence(body) then
+			ParallelFor(body)
+		end if
+
 		Label(pc+7)
 
 		inc = ObjMinMax(Code[pc+1])
@@ -4634,8 +5050,77 @@ procedure opCALL_PROC()
 -- Call by routine id to Euphoria procedure, function or type.
 -- Note that dlls and main programs can't share routine ids, so it's
 -- OK to compute last_max_params just within dll or within main program.
+	symtab_index sub = 0
+	sequence args = {}, temps = {}
+
+	if deferred_args[1] != 0 and deferred_args[1] = Code[pc+2] then
+		-- the arguments were never put in a sequence
+		args = deferred_args[2]
+		sub = direct_call_target(pc, length(args))
+		deferred_args = { 0, {} }
+
+	elsif TypeIs(Code[pc+2], TYPE_SEQUENCE) and SeqLen(Code[pc+2]) != NOVALUE then
+		sub = direct_call_target(pc, SeqLen(Code[pc+2]))
+		if sub and SymTab[sub][S_NUM_ARGS] > 0 then
+			c_stmt("_1 = (object)SEQ_PTR(@);\n", Code[pc+2])
+			c_stmt0("_2 = (object)((s1_ptr)_1)->base;\n")
+			for k = 1 to SymTab[sub][S_NUM_ARGS] do
+				c_stmt0( sprintf( "Ref( *(( (intptr_t*)_2) + %d) );\n", k ) )
+			end for
+		end if
+	end if
+
+	if sub then
+		-- The routine id is known at compile time, so call the routine
+		-- itself, like a normal call.
+		for i = 1 to length(args) do
+			if is_temp( args[i] ) then
+				temps &= args[i]
+				if map:get( dead_temp_walking, args[i], NEW_REFERENCE ) = NO_REFERENCE then
+					CRef(args[i])
+				end if
+			else
+				CRef(args[i])
+			end if
+			SymTab[args[i]][S_ONE_REF] = FALSE
+		end for
+
+		if Code[pc] = CALL_FUNC then
+			c_stmt0("_1 = ")
+			temp_indent = -indent
+		end if
+		LeftSym = TRUE
+		c_stmt("@", sub)
+		c_puts("(")
+		for i = 1 to SymTab[sub][S_NUM_ARGS] do
+			if length(args) then
+				CName(args[i])
+			else
+				c_printf("*(((intptr_t *)_2) + %d)", i)
+			end if
+			if i != SymTab[sub][S_NUM_ARGS] then
+				c_puts(", ")
+			end if
+		end for
+		c_puts(");\n")
+
+		if SymTab[sub][S_EFFECT] then
+			NewBB(1, SymTab[sub][S_EFFECT], sub) -- forget some local & global var values
+		end if
 
-	if last_routine_id > 0 or Code[pc] = CALL_FUNC then
+		if Code[pc] = CALL_FUNC then
+			CDeRef(Code[pc+3])
+			c_stmt("@ = _1;\n", Code[pc+3])
+			SetResultType(sub, Code[pc+3])
+			create_temp( Code[pc+3], 1 )
+		end if
+
+		for i = 1 to length(temps) do
+			-- the routine will deref the parameter
+			dispose_temp( temps[i], SAVE_TEMP, REMOVE_FROM_MAP )
+		end for
+
+	elsif last_routine_id > 0 or Code[pc] = CALL_FUNC then
 		-- only generate code if routine_id()
 		-- was called somewhere, or it's a call_func - otherwise
 		-- return value temp might be used but not declared
@@ -4928,6 +5413,33 @@ procedure opRETURNP()
 	pc += 3
 end procedure
 
+function StaticRoutineId(symtab_index name, integer file_no)
+-- Returns the routine that routine_id(name) will find when called from
+-- file_no, if that is certain at compile time, or 0.
+-- Only plain names of routines in the same file are certain: CRoutineId()
+-- looks in the calling file first.
+	symtab_index s
+	sequence str
+
+	if not find(SymTab[name][S_MODE], {M_TEMP, M_CONSTANT}) or
+	   not t:t_identifier(SymTab[name][S_OBJ]) or atom(SymTab[name][S_OBJ]) then
+		return 0
+	end if
+
+	str = SymTab[name][S_OBJ]
+	s = buckets[hashfn(str)]
+	while s do
+		if equal(str, SymTab[s][S_NAME]) and
+		   SymTab[s][S_FILE_NO] = file_no and
+		   find(SymTab[s][S_TOKEN], RTN_TOKS) and
+		   SymTab[s][S_USAGE] != U_DELETED then
+			return s
+		end if
+		s = SymTab[s][S_SAMEHASH]
+	end while
+	return 0
+end function
+
 procedure opROUTINE_ID()
 	CSaveStr("_0", Code[pc+4], Code[pc+2], 0, 0)
 	c_stmt("@ = CRoutineId(", Code[pc+4])
@@ -4938,6 +5450,13 @@ procedure opROUTINE_ID()
 	CDeRefStr("_0")
 	target = {-1, 1000000}
 	SetBBType(Code[pc+4], TYPE_INTEGER, target, TYPE_OBJECT, 0 )
+
+	if SymTab[Code[pc+4]][S_MODE] = M_CONSTANT then
+		sub = StaticRoutineId(Code[pc+2], Code[pc+3])
+		if sub then
+			map:put(routine_id_constants, Code[pc+4], sub)
+		end if
+	end if
 	pc += 5
 end procedure
 
@@ -5502,7 +6021,7 @@ procedure opEQUAL()
 						 {Code[pc+1], Code[pc+2]})
 	c_stmt("@ = 0;\n", Code[pc+3])
 	c_stmt0("else\n")
-	c_stmt("@ = (compare(@, @) == 0);\n", {Code[pc+3], Code[pc+1], Code[pc+2]})
+	c_stmt("@ = equal(@, @);\n", {Code[pc+3], Code[pc+1], Code[pc+2]})
 	CDeRefStr("_0")
 	target = {0, 1}
 	SetBBType(Code[pc+3], TYPE_INTEGER, target, TYPE_OBJECT, 0)
@@ -7437,7 +7956,7 @@ procedure BackEnd(atom ignore)
 	-- Now, actually emit the C code */
 	emit_c_output = TRUE
 
-	c_code = open(output_dir & "main-.c", "w")
+	c_code = open_generated("main-.c")
 	if c_code = -1 then
 		CompileErr(CANT_OPEN_MAINC_FOR_OUTPUT)
 	end if
@@ -7627,6 +8146,7 @@ procedure BackEnd(atom ignore)
 		c_stmt0("eu_startup(_00, _01, _02, (object)CLOCKS_PER_SEC, (object)sysconf(_SC_CLK_TCK));\n")
 		c_puts("#endif\n")
     m_stmtln("#endif")
+	c_stmt0("eu_name_hash(&_03, &_04);\n")
 	
 	c_stmt0( sprintf( "trace_lines = %d;\n", trace_lines ) )
 
@@ -7691,7 +8211,7 @@ procedure BackEnd(atom ignore)
 	write_checksum( c_code )
 	close(c_code)
 
-	c_code = open(output_dir & "init-.c", "a")
+	c_code = open_generated("init-.c", "a")
 	if c_code = -1 then
 		CompileErr(CANT_OPEN_INITC_FOR_APPEND)
 	end if
@@ -7813,6 +8333,7 @@ procedure BackEnd(atom ignore)
 	close(c_code)
 	close(c_h)
 
+	commit_generated_files()
 	write_buildfile()
 end procedure
 mode:set_backend( routine_id("BackEnd") )
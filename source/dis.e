@@ -1389,7 +1389,7 @@ procedure write_call_info( sequence name )
 
 	-- called_from:  file -> proc -> called_proc file : called proc
 	-- called_by  :  called_proc file -> called proc -> file : proc
-	sequence files = map:keys( called_from )
+	sequence files = map:keys( called_from, 1 )
 
 	integer fn = open( name & "calls", "w" )
 	sequence pp = PRETTY_DEFAULT
@@ -48,14 +48,14 @@ end procedure
 function edges( map:map call_map, integer proc, integer files, integer direction )
 	integer file = SymTab[proc][S_FILE_NO]
 	map:map proc_map = new_extra( map:nested_get( call_map, { file, proc } ) )
-	sequence from_files = map:keys( proc_map )
+	sequence from_files = map:keys( proc_map, 1 )
 	
 	sequence lines = {}
 	for i = 1 to length( from_files ) do
 		if and_bits( INTER_FILE, files ) or file = from_files[i] then
 			
 			map:map file_map = new_extra( map:get( proc_map, from_files[i]) )
-			sequence procs = map:keys( file_map )
+			sequence procs = map:keys( file_map, 1 )
 			sequence edge_lines = ""
 			integer edge_count = 0
 			for j = 1 to length( procs ) do
@@ -92,10 +92,10 @@ end function
 
 function clusters()
 	sequence lines = {}
-	sequence call_type = map:keys( cluster )
+	sequence call_type = map:keys( cluster, 1 )
 	for ct = 1 to length( call_type ) do
 		map:map file_map = new_extra( map:get( cluster, call_type[ct]) )
-		sequence files = map:keys( file_map )
+		sequence files = map:keys( file_map, 1 )
 		for f = 1 to length( files ) do
 			integer fn = files[f]
 			if call_type[ct] then
@@ -106,7 +106,7 @@ function clusters()
 						{ known_files[fn] } )
 			end if
 			map:map token_map = new_extra( map:get( file_map, fn) )
-			sequence tokens = map:keys( token_map )
+			sequence tokens = map:keys( token_map, 1 )
 			for t = 1 to length( tokens ) do
 				sequence fill
 				integer token = tokens[t]
@@ -117,7 +117,7 @@ function clusters()
 				end if
 				
 				map:map scope_map = new_extra( map:get( token_map, token) )
-				sequence scopes = map:keys( scope_map )
+				sequence scopes = map:keys( scope_map, 1 )
 				for s = 1 to length( scopes ) do
 					integer scope = scopes[s]
 					sequence shape
@@ -130,7 +130,7 @@ function clusters()
 					end if
 					
 					map:map proc_map = new_extra( map:get( scope_map, scope) )
-					sequence procs = map:keys( proc_map )
+					sequence procs = map:keys( proc_map, 1 )
 					lines &= sprintf( "\t\t\tnode [%s%s]\n", {shape, fill})
 					for p = 1 to length( procs ) do
 						symtab_index proc = procs[p]
@@ -171,13 +171,13 @@ end function
 function routine_ref( integer f, symtab_index proc, map:map call_map )
 	map:map file_map = new_extra( map:nested_get( call_map, {f, proc}) )
 	
-	sequence files = map:keys( file_map )
+	sequence files = map:keys( file_map, 1 )
 	sequence names = {}
 	for fx = 1 to length( files ) do
 		integer fn = files[fx]
 		if not std_libs[fn] then
 			map:map proc_map = new_extra( map:get( file_map, fn) )
-			sequence procs = map:keys( proc_map )
+			sequence procs = map:keys( proc_map, 1 )
 			for p = 1 to length( procs ) do
 				symtab_index psym = procs[p]
 				if SymTab[psym][S_SCOPE] != SC_PREDEF then
@@ -301,7 +301,7 @@ procedure call_graphs()
 		return
 	end if
 	
-	sequence files = map:keys( routine_map )
+	sequence files = map:keys( routine_map, 1 )
 	for f = 1 to length( files ) do
 		integer file = files[f]
 		if not std_libs[file] then
@@ -1478,7 +1478,7 @@ procedure main()
 
 	string_of_strings files = {}
 	map opts = cmd_parse( cmdopts )
-	sequence keys = map:keys( opts )
+	sequence keys = map:keys( opts, 1 )
 	sequence output_format = ASCII_output
 	no_check = map:has( opts, "n") or map:has( opts, "nocheck" )
 	
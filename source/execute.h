@@ -139,6 +139,13 @@ struct ns_list {
 	int file_num;
 };
 
+struct name_hash {  /* perfect hash of the names in a routine_list or ns_list */
+	int size;       /* number of distinct names */
+	int *disp;      /* per bucket: hash seed, or -1 - slot for a lone name */
+	int *first;     /* per slot: index of the first entry with the name */
+	int *next;      /* per entry: index of the next entry with the same name, or -1 */
+};
+
 struct sline {      /* source line table entry */
 	char *src;               /* text of line,
 								first 4 bytes used for count when profiling */
@@ -452,6 +459,24 @@ struct char_cell {
 #define M_INIT_DEBUGGER      104
 #define M_A_TO_F80           105
 #define M_MACHINE_INFO       106
+#define M_FREE_BUDGET        107
+#define M_HEAP_STATS         108
+#define M_ALLOC_SAMPLE       109
+#define M_ALLOC_SITES        110
+#define M_INTERN             111
+#define M_INTERN_PURGE       112
+#define M_ARENA_BEGIN        113
+#define M_ARENA_END          114
+#define M_SPRINT             115
+#define M_GET_VALUE          116
+#define M_HASH_INIT          117
+#define M_HASH_UPDATE        118
+#define M_HASH_FINAL         119
+#define M_SPLIT              120
+#define M_SPLIT_ANY          121
+#define M_JOIN               122
+#define M_TRIM               123
+#define M_CHANGE_CASE        124
 
 enum CLEANUP_TYPES {
 	CLEAN_UDT,
@@ -526,11 +526,13 @@ export integer OpProfileTime        -- time profile option currently on
 export sequence OpDefines = {}      -- defines
 export integer OpInline             -- inline max size (0 = off)
 export integer OpIndirectInclude
+export integer OpParallel = FALSE   -- for loops may run as OpenMP loops
 
 -- COMPILE only
 export object dj_path = 0, wat_path = 0
 export integer cfile_count = 0, cfile_size = 0
 export integer Initializing = FALSE
+export sequence parallel_loops = {} -- loop vars of for loops under "with parallel"
 
 export sequence temp_name_type = repeat({0, 0}, 4)  -- skip 1..4
 export enum
@@ -287,7 +287,7 @@ export procedure handle_options_for_bind( m:map opts )
 	integer op
 	integer file_supplied = 0
 
-	opt_keys = m:keys(opts)
+	opt_keys = m:keys(opts, 1)
 	op = 1
 	while op <= length(opt_keys) do
 		option = opt_keys[op]
@@ -52,7 +52,7 @@ export procedure intoptions()
 	
 	handle_common_options(opts)
 
-	sequence opt_keys = map:keys(opts)
+	sequence opt_keys = map:keys(opts, 1)
 	integer option_w = 0
 
 	for idx = 1 to length(opt_keys) do
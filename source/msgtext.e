@@ -109,7 +109,7 @@ public type enum message_index
     FOUND_1_2_BUT_WAS_EXPECTING_A_PARAMETER_NAME_INSTEAD,
     FOUND_1_BUT_EXPECTED_ELSE_AN_ATOM_STRING_CONSTANT_OR_ENUM,
     FOUND_1_BUT_WAS_EXPECTING_A_PARAMETER_NAME_INSTEAD,
-    MSG_DELETED,
+    LINK_TIME_OPTIMIZATION_GCC_ONLY,
     FRACTIONAL_PART_OF_NUMBER_IS_MISSING,
     FILE_NAME_IS_MISSING,
     GOTO_STATEMENT_WITHOUT_A_STRING_LABEL,
@@ -178,7 +178,7 @@ public type enum message_index
     WATCOM_ENVIRONMENT_VARIABLE_IS_NOT_SET,
     WARNING_NAMES_MUST_BE_ENCLOSED_IN,
     MSG__MAY_ONLY_BE_ON_THE_FIRST_LINE_OF_A_PROGRAM,
-    MSG_DELETED_A,
+    PROFILE_GUIDED_OPTIMIZATION_STEP_GCC_ONLY,
     COMPILING_130_2,
     COULDNT_COMPILE_FILE_1,
     STATUS_1_COMMAND_2,
@@ -211,7 +211,7 @@ public type enum message_index
     GENERATE_A_PARTIAL_PROJECT_MAKEFILE,
     GENERATE_A_FULL_MAKEFILE,
     COULD_NOT_REMOVE_DIRECTORY_1,
-    MSG_DELETED_B,
+    NUMBER_OF_COMPILER_PROCESSES_TO_RUN_AT_ONCE,
     DO_NOT_BUILD_THE_PROJECT_NOR_WRITE_A_BUILD_FILE,
     GENERATECOMPILE_ALL_FILES_IN_DIR,
     SET_THE_OUTPUT_FILENAME,
@@ -258,7 +258,7 @@ public type enum message_index
     TRANSLATING_CODE_PASS,
     MSG__GENERATING,
     MSG_1,
-    MSG_DELETED_C,
+    INVALID_NUMBER_OF_JOBS,
     COULDNT_OPEN_DELETEDTXT,
     DELETED_SYMBOLS,
     THE_LIST_OF_DELETED_SYMBOLS_IS_IN_DELETEDTXT,
@@ -383,6 +383,13 @@ public type enum message_index
     BUILDDIR_IS_UNDEFINED,
 	NUMBER_IS_TOO_SMALL,
 	NUMBER_IS_TOO_BIG,
+    USE_THE_SHARED_OBJECT_CACHE,
+    SET_THE_OBJECT_CACHE_DIRECTORY,
+    SET_THE_OBJECT_CACHE_SIZE_IN_MEGABYTES,
+    INVALID_OBJECT_CACHE_SIZE,
+    COULDNT_OPEN_OBJECT_CACHE_1,
+    CACHED_130_2,
+    OBJECT_CACHE_12_HITS_34_MISSES_5_MB,
     $
 end type
 
@@ -422,6 +429,7 @@ constant StdErrMsgs = {
     { BREAK_STATEMENT_MUST_BE_INSIDE_A_IF_OR_A_SWITCH_BLOCK, "break statement must be inside a if or a switch block" },
     { BUILDDIR_IS_FILE                             , "Error: Specified build directory is a file" },
     { BUILDDIR_IS_UNDEFINED                        , "Error: Specified build directory is undefined (wildcards are not allowed)" },
+    { CACHED_130_2                                 , "Cached    [1:3.0]% [2]" },
     { CANNOT_BUILD_A_DLL_FOR_DOS                   , "cannot build a dll for DOS" },
     { CANNOT_USE_THE_FILENAME_1_UNDER_DOSUSE_THE_WINDOWS_VERSION_WITH_PLAT_DOS_INSTEAD, "Cannot use the filename, [1], under DOS.\nUse the Windows version with -plat DOS instead.\n" },
     { CANT_CREATE_ERROR_MESSAGE_FILE_1             , "Can't create error message file: [1]\n" },
@@ -445,6 +453,7 @@ constant StdErrMsgs = {
     { COULDNT_OPEN_12_FOR_WRITING                  , "Couldn't open [1][2] for writing" },
     { COULDNT_OPEN_C_FILE_FOR_OUTPUT               , "Couldn't open .c file for output" },
     { COULDNT_OPEN_DELETEDTXT                      , "Couldn't open deleted.txt" },
+    { COULDNT_OPEN_OBJECT_CACHE_1                  , "Couldn't open the object cache [1], compiling everything" },
     { COULD_NOT_CREATE_COVERAGE_DATABASE_1         , "Could not create coverage database: [1]" },
     { COULD_NOT_CREATE_COVERAGE_TABLE_1            , "Could not create coverage table: [1]" },
     { COULD_NOT_ERASE_COVERAGE_DATABASE_1          , "Could not erase coverage database: [1]" },
@@ -559,11 +568,14 @@ constant StdErrMsgs = {
     { INVALID_CHARACTER_IN_HEX_STRING              , "Invalid character in HEX string" },
     { INVALID_MAXIMUM_FILE_SIZE                    , "Invalid maximum file size" },
     { INVALID_NUMBER_BASE_SPECIFIER_1              , "Invalid number base specifier '[1]'" },
+    { INVALID_NUMBER_OF_JOBS                       , "Invalid number of jobs" },
+    { INVALID_OBJECT_CACHE_SIZE                    , "Invalid object cache size" },
     { INVALID_OPTION_1                             , "Invalid option: [1]" },
     { KEEP_THE_GENERATED_FILES                     , "Keep the generated files" },
     { LEAVING_TOO_MANY_BLOCKS_1__2                 , "leaving too many blocks [1] > [2]" },
     { LINKING_100_1                                , "Linking 100% [1]" },
     { LINK_RESOURCE_FILE_INTO_RESULTING_EXECUTABLE , "Link resource file into resulting executable" },
+    { LINK_TIME_OPTIMIZATION_GCC_ONLY              , "Optimize across C files and the runtime library at link time (GCC only)" },
     { LIST_UNUSED_DELETED_SYMBOLS_IN_DELETEDTXT    , "List unused (deleted) symbols in 'deleted.txt'" },
     { MAY_NOT_ASSIGN_TO_A_FORLOOP_VARIABLE         , "may not assign to a for-loop variable" },
     { MAY_NOT_CHANGE_THE_VALUE_OF_A_CONSTANT       , "may not change the value of a constant" },
@@ -613,10 +625,6 @@ constant StdErrMsgs = {
     { MSG_1__PRIVATE_VARIABLE_2_OF_3_IS_NEVER_ASSIGNED_A_VALUE, "[1] - private variable \'[2]\' of [3] is read from but never assigned a value" },
     { MSG_1__PRIVATE_VARIABLE_2_OF_3_IS_NOT_USED   , "[1] - private variable '[2]' of [3]() is not used" },
     { MSG_CC_PREFIX                                , "Prefix for compiler and related binaries" },
-    { MSG_DELETED                                  , "-deleted-" },
-    { MSG_DELETED_A                                , "-deleted-" },
-    { MSG_DELETED_B                                , "-deleted-" },
-    { MSG_DELETED_C                                , "-deleted-" },
     { MSG_ENDOFFILE                                , "<end-of-file>\n" },
     { MSG_END_HAS_NO_MATCHING_1                    , "'end' has no matching '[1]'" },
     { MSG_GLOBAL_MUST_BE_FOLLOWED_BYA_TYPE_CONSTANT_ENUM_PROCEDURE_TYPE_OR_FUNCTION, "'global' must be followed by:\n<a type>, 'constant', 'enum', 'procedure', 'type' or 'function'" },
@@ -646,6 +654,8 @@ constant StdErrMsgs = {
 	{ NUMBER_IS_TOO_SMALL                          , "The number specified here is too small."},
 	{ NUMBER_IS_TOO_BIG                            , "The number specified here is too big."},
     { NUMBER_NOT_FORMED_CORRECTLY                  , "number not formed correctly" },
+    { NUMBER_OF_COMPILER_PROCESSES_TO_RUN_AT_ONCE  , "Number of compiler processes to run at once (default: one per processor)" },
+    { OBJECT_CACHE_12_HITS_34_MISSES_5_MB          , "Object cache: [1] hits, [2] misses this build, [3] hits, [4] misses in all, [5] MB used" },
     { OBSOLETE_IL_FILE_PLEASE_RECREATE_IT_USING_EUPHORIA_40_OR_LATER, "Obsolete .il file. Please recreate it using Euphoria 4.0 or later." },
     { ONLY_ENUMS_MAY_BE_DECLARED_AS_TYPES          , "Only enums may be declared as types" },
     { ONLY_INTEGER_LITERALS_CAN_USE_THE_01_FORMAT  , "Only integer literals can use the '0[1]' format" },
@@ -658,6 +668,7 @@ constant StdErrMsgs = {
     { PREPARES_A_FILE_FOR_USE_ON_WINDOWS           , "Prepares a file for use on Windows" },
     { PRESS_ENTER                                  , "\nPress Enter\n" },
     { PRESS_ENTER_TO_CONTINUE_Q_TO_QUIT            , "\nPress Enter to continue, q to quit\n" },
+    { PROFILE_GUIDED_OPTIMIZATION_STEP_GCC_ONLY    , "Profile guided optimization: 'gen' builds an instrumented program, 'use' rebuilds with its profile (GCC only)" },
     { PROGRAM_INCLUDES_TOO_MANY_FILES              , "program includes too many files" },
     { PUNCTUATION_MISSING_IN_BETWEEN_NUMBER_AND_1  , "Punctuation missing in between number and '[1]'" },
     { RAW_STRING_LITERAL_FROM_LINE_1_NOT_TERMINATED, "Raw string literal from line [1] not terminated." },
@@ -674,6 +685,8 @@ constant StdErrMsgs = {
     { SET_THE_COMPILER_TO_GCC                      , "Set the compiler to GCC" },
     { SET_THE_COMPILER_TO_WATCOM                   , "Set the compiler to Watcom" },
     { SET_THE_NUMBER_OF_C_STATEMENTS_PER_GENERATED_FILE_BEFORE_SPLITTING, "Set the number of C statements per generated file before splitting." },
+    { SET_THE_OBJECT_CACHE_DIRECTORY               , "Directory of the object cache (implies -obj-cache)" },
+    { SET_THE_OBJECT_CACHE_SIZE_IN_MEGABYTES       , "Size the object cache is kept to, in megabytes (default: 512)" },
     { SET_THE_OUTPUT_FILENAME                      , "Set the output filename" },
     { SET_THE_PLATFORM_FOR_THE_TRANSLATED_CODE     , "Set the platform for the translated code" },
     { SET_THE_STACK_SIZE_WATCOM                    , "Set the stack size (Watcom)" },
@@ -739,6 +752,7 @@ constant StdErrMsgs = {
     { USER_SUPPLIED_LIBRARY_DOES_NOT_EXIST__1      , "User supplied library does not exist:\n    [1]" },
     { USE_A_NONSTANDARD_LIBRARY                    , "Use a non-standard library" },
     { USE_THE_MNOCYGWIN_FLAG_WITH_MINGW            , "Use the -mno-cygwin flag with MinGW" },
+    { USE_THE_SHARED_OBJECT_CACHE                  , "Reuse compiled objects shared between builds" },
     { USING_MANAGED_MEMORY                         , "Using Managed Memory" },
     { USING_SYSTEM_MEMORY                          , "Using System Memory" },
     { VARIABLE_1_HAS_NOT_BEEN_DECLARED             , "Variable [1] has not been declared" },
@@ -0,0 +1,286 @@
+-- (c) Copyright - See License.txt
+--
+-- Cache of compiled object files shared by translator runs
+
+ifdef ETYPE_CHECK then
+	with type_check
+elsedef
+	without type_check
+end ifdef
+
+include std/convert.e
+include std/filesys.e
+include std/hash.e
+include std/io.e
+include std/os.e
+include std/search.e
+include std/sequence.e
+include std/sort.e
+include std/text.e
+
+--**
+-- Directory holding the cached objects, or "" when the cache is not used
+
+export sequence obj_cache_dir = ""
+
+--**
+-- Size in bytes the cache is trimmed to after each build
+
+export atom obj_cache_size = 512 * 1024 * 1024
+
+--**
+-- Cache hits and misses of this build
+
+export integer cache_hits = 0, cache_misses = 0
+
+constant STATS_FILE = "stats"
+
+--**
+-- Returns the directory the cache uses when none is given.
+
+export function default_cache_dir()
+	object base
+
+	ifdef WINDOWS then
+		base = getenv("LOCALAPPDATA")
+		if atom(base) then
+			base = getenv("APPDATA")
+		end if
+	elsedef
+		base = getenv("XDG_CACHE_HOME")
+		if atom(base) then
+			base = getenv("HOME")
+			if sequence(base) then
+				base = join_path({ base, ".cache" })
+			end if
+		end if
+	end ifdef
+
+	if atom(base) then
+		base = current_dir()
+	end if
+
+	return join_path({ base, "euphoria", "objcache" }) & SLASH
+end function
+
+--**
+-- Starts using the cache in ##cache_dir##, creating it if needed.
+--
+-- Returns:
+--   0 if the directory could not be created.
+
+export function open_cache(sequence cache_dir)
+	cache_dir = canonical_path(cache_dir)
+	if not find(cache_dir[$], SLASHES) then
+		cache_dir &= SLASH
+	end if
+
+	if not file_exists(cache_dir) and not create_directory(cache_dir) then
+		return 0
+	end if
+
+	obj_cache_dir = cache_dir
+	return 1
+end function
+
+--**
+-- Returns what, besides a C file itself, decides the object it compiles to:
+-- the compiler command, the runtime headers and the parts of the shared
+-- generated header that are not plain declarations of program symbols.
+--
+-- Those declarations differ from program to program, but a C file only
+-- compiles differently because of them when its own text changes too.
+
+export function cache_salt(sequence compile_cmd, sequence main_header, sequence include_dir)
+	sequence salt = compile_cmd & 0
+
+	object headers = dir(join_path({ include_dir, "include", "*.h" }))
+	if sequence(headers) then
+		headers = sort(headers)
+		for i = 1 to length(headers) do
+			object text = read_file(join_path({ include_dir, "include", headers[i][D_NAME] }))
+			if sequence(text) then
+				salt &= headers[i][D_NAME] & 0 & text
+			end if
+		end for
+	end if
+
+	object lines = read_lines(main_header)
+	if sequence(lines) then
+		for i = 1 to length(lines) do
+			sequence line = lines[i]
+			if begins("extern object _", line) then
+				continue
+			end if
+			if (begins("object _", line) or begins("void _", line)) and
+				ends(");", line)
+			then
+				-- routine prototype, exported DLL routines are kept
+				-- because they are called differently
+				continue
+			end if
+			salt &= line & '\n'
+		end for
+	end if
+
+	return salt
+end function
+
+--**
+-- Returns the cache key of the object compiled from ##c_file##, or 0
+-- if the file can't be read.
+--
+-- The entry is named after a hash of the key, and the text the hash was
+-- taken of is stored beside it and compared on every lookup, so two keys
+-- with the same hash are never mixed up.
+
+export function cache_key(sequence c_file, sequence salt)
+	object text = read_file(c_file)
+	if atom(text) then
+		return 0
+	end if
+
+	text = salt & 0 & text
+	return { sprintf("%08x%08x%x", { hash(text, HSIEH32), hash(text, FLETCHER32), length(text) }),
+		c_file, salt }
+end function
+
+-- the text the cache key of key was taken of
+function key_text(sequence key)
+	object text = read_file(key[2])
+	if atom(text) then
+		return 0
+	end if
+	return key[3] & 0 & text
+end function
+
+-- copies src to the cache entry dest without readers ever seeing half a file
+function store(sequence src, sequence dest)
+	sequence tmp = temp_file(obj_cache_dir, "new-", "tmp")
+	if not copy_file(src, tmp, 1) then
+		delete_file(tmp)
+		return 0
+	end if
+	if not move_file(tmp, dest, 1) then
+		delete_file(tmp)
+		return 0
+	end if
+	return 1
+end function
+
+-- writes text to the cache file dest the same way
+function store_text(sequence text, sequence dest)
+	sequence tmp = temp_file(obj_cache_dir, "new-", "tmp")
+	if write_file(tmp, text) != 1 then
+		delete_file(tmp)
+		return 0
+	end if
+	if not move_file(tmp, dest, 1) then
+		delete_file(tmp)
+		return 0
+	end if
+	return 1
+end function
+
+--**
+-- Copies the cached object for ##key## to ##obj##.
+--
+-- Returns:
+--   1 on a cache hit, 0 on a miss.
+
+export function cache_fetch(object key, sequence obj)
+	if atom(key) then
+		return 0
+	end if
+
+	sequence entry = obj_cache_dir & key[1] & ".o"
+	object info = dir(entry)
+	if atom(info) or length(info) != 1 or
+		not equal(read_file(obj_cache_dir & key[1] & ".key"), key_text(key)) or
+		not copy_file(entry, obj, 1)
+	then
+		cache_misses += 1
+		return 0
+	end if
+
+	-- objects are evicted by age, so keep the ones in use young
+	sequence today = date()
+	if info[1][D_YEAR] != today[1] + 1900 or info[1][D_MONTH] != today[2] or
+		info[1][D_DAY] != today[3]
+	then
+		store(obj, entry)
+	end if
+
+	cache_hits += 1
+	return 1
+end function
+
+--**
+-- Puts the object ##obj##, compiled for ##key##, into the cache.
+
+export procedure cache_put(object key, sequence obj)
+	if atom(key) then
+		return
+	end if
+
+	object text = key_text(key)
+	if sequence(text) and store_text(text, obj_cache_dir & key[1] & ".key") then
+		store(obj, obj_cache_dir & key[1] & ".o")
+	end if
+end procedure
+
+--**
+-- Records the hits and misses of this build and removes the oldest objects
+-- until the cache fits in obj_cache_size.
+--
+-- Returns:
+--   { total hits, total misses, size in bytes } of the cache.
+
+export function cache_finish()
+	sequence stats = { 0, 0 }
+	object text = read_file(obj_cache_dir & STATS_FILE, TEXT_MODE)
+	if sequence(text) then
+		sequence counts = split(trim(text), ' ')
+		if length(counts) = 2 then
+			stats = { to_integer(counts[1]), to_integer(counts[2]) }
+		end if
+	end if
+	stats += { cache_hits, cache_misses }
+	write_file(obj_cache_dir & STATS_FILE, sprintf("%d %d\n", stats), TEXT_MODE)
+
+	object entries = dir(obj_cache_dir & "*.o")
+	if atom(entries) then
+		return stats & 0
+	end if
+
+	atom size = 0
+	for i = 1 to length(entries) do
+		-- an object and the key stored beside it are removed together
+		atom entry_size = entries[i][D_SIZE]
+		sequence name = filebase(entries[i][D_NAME])
+		atom key_size = file_length(obj_cache_dir & name & ".key")
+		if key_size > 0 then
+			entry_size += key_size
+		end if
+		size += entry_size
+		-- oldest first when sorted
+		entries[i] = entries[i][D_YEAR..D_SECOND] & { entry_size, name }
+	end for
+
+	if size > obj_cache_size then
+		entries = sort(entries)
+		-- trim a little further, so this doesn't happen on every build
+		atom limit = obj_cache_size * 0.9
+		for i = 1 to length(entries) do
+			if size <= limit then
+				exit
+			end if
+			if delete_file(obj_cache_dir & entries[i][$] & ".o") then
+				delete_file(obj_cache_dir & entries[i][$] & ".key")
+				size -= entries[i][$-1]
+			end if
+		end for
+	end if
+
+	return stats & size
+end function
@@ -3296,6 +3296,9 @@ procedure For_statement()
 		Pop_block_var()
 	end if
 	SymTab[loop_var_sym][S_USAGE] = or_bits(SymTab[loop_var_sym][S_USAGE], U_USED)
+	if TRANSLATE and OpParallel then
+		parallel_loops &= loop_var_sym
+	end if
 
 	op_info1 = loop_var_sym
 	emit_op(FOR)
@@ -4675,6 +4678,9 @@ procedure SetWith(integer on_off)
 	elsif equal( option, "indirect_includes" ) then
 		OpIndirectInclude = on_off
 
+	elsif equal(option, "parallel") then
+		OpParallel = on_off
+
 	elsif equal(option, "batch") then
 		batch_job = on_off
 
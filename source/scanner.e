@@ -101,7 +101,8 @@ constant FILE_NO = 1,           -- file number
 		 LAST_FORWARD_BP = 19,
 		 THISLINE = 20,
 		 FWD_LINE_NUMBER = 21,
-		 FORWARD_BP = 22
+		 FORWARD_BP = 22,
+		 OP_PARALLEL = 23
 		 -- , OP_PREV_INDIRECT_INCLUDE = 14 -- not used
 
 integer qualified_fwd = -1 -- remember namespaces for forward reference purposes
@@ -864,7 +865,8 @@ procedure IncludePush()
 							   last_forward_bp,
 							   ThisLine,
 							   fwd_line_number,
-							   forward_bp})
+							   forward_bp,
+							   OpParallel})
 
 	file_include = append( file_include, {} )
 	file_include_by = append( file_include_by, {} )
@@ -970,6 +972,7 @@ export function IncludePop()
 	prev_OpWarning     = top[PREV_OP_WARNING]
 	OpInline           = top[OP_INLINE]
 	OpIndirectInclude  = top[OP_INDIRECT_INCLUDE]
+	OpParallel         = top[OP_PARALLEL]
 	putback_fwd_line_number = line_number -- top[PUTBACK_FWD_LINE_NUMBER]
 	putback_ForwardLine = top[PUTBACK_FORWARDLINE]
 	putback_forward_bp = top[PUTBACK_FORWARD_BP]
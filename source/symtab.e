@@ -607,7 +607,7 @@ export procedure mark_final_targets()
 			mark_all( S_NREFS )
 		end if
 	elsif map:size( recheck_routines ) then
-		sequence recheck_files = map:keys( recheck_routines )
+		sequence recheck_files = map:keys( recheck_routines, 1 )
 		for i = 1 to length( recheck_files ) do
 			mark_rechecks( recheck_files[i] )
 		end for
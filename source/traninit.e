@@ -64,6 +64,7 @@ include error.e
 include platform.e
 include buildsys.e
 include msgtext.e
+include objcache.e
 
 function extract_options(sequence s)
 	return s
@@ -91,6 +92,12 @@ sequence trans_opt_def = {
 	{ "keep",             0, GetMsgText(KEEP_THE_GENERATED_FILES,0), { } },
 	{ "nobuild",          0, GetMsgText(DO_NOT_BUILD_THE_PROJECT_NOR_WRITE_A_BUILD_FILE,0), { } },
 	{ "force-build",      0, GetMsgText(FORCE_BUILDING_EVEN_IF_FILE_IS_UPTODATE,0), { } },
+	{ "jobs",             0, GetMsgText(NUMBER_OF_COMPILER_PROCESSES_TO_RUN_AT_ONCE,0), { HAS_PARAMETER, "count" } },
+	{ "obj-cache",        0, GetMsgText(USE_THE_SHARED_OBJECT_CACHE,0), { } },
+	{ "obj-cache-dir",    0, GetMsgText(SET_THE_OBJECT_CACHE_DIRECTORY,0), { HAS_PARAMETER, "dir" } },
+	{ "obj-cache-size",   0, GetMsgText(SET_THE_OBJECT_CACHE_SIZE_IN_MEGABYTES,0), { HAS_PARAMETER, "megabytes" } },
+	{ "lto",              0, GetMsgText(LINK_TIME_OPTIMIZATION_GCC_ONLY,0), { } },
+	{ "pgo",              0, GetMsgText(PROFILE_GUIDED_OPTIMIZATION_STEP_GCC_ONLY,0), { HAS_PARAMETER, "gen|use" } },
 	{ "makefile",         0, GetMsgText(GENERATE_A_FULL_MAKEFILE,0), { } },
 	{ "makefile-partial", 0, GetMsgText(GENERATE_A_PARTIAL_PROJECT_MAKEFILE,0), { } },
 	{ "silent",           0, GetMsgText(DO_NOT_DISPLAY_STATUS_MESSAGES,0), { } },
@@ -122,8 +129,9 @@ end ifdef
 
 	handle_common_options(opts)
 
-	sequence opt_keys = map:keys(opts)
+	sequence opt_keys = map:keys(opts, 1)
 	integer option_w = 0
+	sequence obj_cache_request = ""
 
 	for idx = 1 to length(opt_keys) do
 		
@@ -229,6 +237,46 @@ end ifdef
 					abort(1)
 				end if
 
+			case "jobs" then
+				sequence tmp = value(val)
+				if tmp[1] = GET_SUCCESS and integer(tmp[2]) and tmp[2] >= 0 then
+					max_jobs = tmp[2]
+				else
+					ShowMsg(2, INVALID_NUMBER_OF_JOBS)
+					abort(1)
+				end if
+
+			case "obj-cache" then
+				if length(obj_cache_request) = 0 then
+					obj_cache_request = default_cache_dir()
+				end if
+
+			case "obj-cache-dir" then
+				obj_cache_request = val
+
+			case "obj-cache-size" then
+				sequence tmp = value(val)
+				if tmp[1] = GET_SUCCESS and atom(tmp[2]) and tmp[2] > 0 then
+					obj_cache_size = tmp[2] * 1024 * 1024
+				else
+					ShowMsg(2, INVALID_OBJECT_CACHE_SIZE)
+					abort(1)
+				end if
+
+			case "lto" then
+				lto_option = TRUE
+
+			case "pgo" then
+				switch val do
+					case "gen" then
+						pgo_option = PGO_GEN
+					case "use" then
+						pgo_option = PGO_USE
+					case else
+						ShowMsg(2, INVALID_OPTION_1, { "-pgo " & val })
+						abort(1)
+				end switch
+
 			case "keep" then
 				keep = TRUE
 
@@ -274,6 +322,10 @@ end ifdef
 		end switch
 	end for
 
+	if length(obj_cache_request) and not open_cache(obj_cache_request) then
+		ShowMsg(2, COULDNT_OPEN_OBJECT_CACHE_1, { obj_cache_request })
+	end if
+
 	-- validate user supplied libraries (if necessary)
 	if dll_option then
 		if TX86_64  then
@@ -310,16 +362,23 @@ end ifdef
 
 	ifdef not EUDIS then
 		if build_system_type = BUILD_DIRECT and length(output_dir) = 0 then
-			output_dir = temp_file("." & SLASH, "build-", "")
-			if find(output_dir[$], "/\\") = 0 then
-				output_dir &= '/'
+			if pgo_option != PGO_NONE then
+				-- the compiler finds profile data by object file path, so
+				-- -pgo gen and -pgo use must build in the same place
+				output_dir = filebase(map:get(opts, OPT_EXTRAS)[1]) & "-pgo" & SLASH
+				create_directory(output_dir)
+			else
+				output_dir = temp_file("." & SLASH, "build-", "")
+				if find(output_dir[$], "/\\") = 0 then
+					output_dir &= '/'
+				end if
+
+				remove_output_dir = 1
 			end if
-	
+
 			if not silent then
 				printf(1, "Build directory: %s\n", { abbreviate_path(output_dir) })
 			end if
-			
-			remove_output_dir = 1
 		end if
 	end ifdef
 	
@@ -338,7 +397,7 @@ procedure OpenCFiles()
 		create_directory(output_dir)
 	end if
 
-	c_code = open(output_dir & "init-.c", "w")
+	c_code = open_generated("init-.c")
 	if c_code = -1 then
 		CompileErr(CANT_OPEN_INITC_FOR_OUTPUT)
 	end if
@@ -351,7 +410,7 @@ procedure OpenCFiles()
 	c_puts("include/euphoria.h\"\n")
 
 	c_puts("#include \"main-.h\"\n\n")
-	c_h = open(output_dir & "main-.h", "w")
+	c_h = open_generated("main-.h")
 	if c_h = -1 then
 		CompileErr(CANT_OPEN_MAINH_FILE_FOR_OUTPUT)
 	end if
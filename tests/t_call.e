@@ -16,6 +16,31 @@ call_proc(r_foo, {5})
 test_equal("procedure call", 5, gb)
 test_equal("function call", 15, call_func(r_bar, {10}))
 
+-- constant routine ids let the translator call the routine directly
+function join3(sequence a, object b, sequence c)
+	return a & b & c
+end function
+
+function count_calls()
+	gb += 1
+	return gb
+end function
+
+constant
+	R_FOO = routine_id("foo"),
+	R_JOIN3 = routine_id("join3"),
+	R_COUNT = routine_id("count_calls")
+
+sequence s = "abc"
+call_proc(R_FOO, {length(s) * 2})
+test_equal("constant id procedure call", 6, gb)
+test_equal("constant id function call with temps", "abc-abcdef",
+	call_func(R_JOIN3, {s, '-', s & "def"}))
+test_equal("argument still valid after the call", "abc", s)
+test_equal("constant id function call without arguments", 7, call_func(R_COUNT, {}))
+sequence args = {"x", "y", "z"}
+test_equal("constant id function call with argument sequence", "xyz", call_func(R_JOIN3, args))
+test_equal("argument sequence still valid after the call", {"x", "y", "z"}, args)
 
 test_report()
 
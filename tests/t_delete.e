@@ -64,6 +64,11 @@ s = delete_routine( delete_routine( repeat( 0, 1 ), CUSTOM_DELETE ), CUSTOM_DELE
 s = ""
 test_equal( "sequence, 2 delete routines, deleted by derefs", 2, delete_count() )
 
+s = delete_routine( "%d", CUSTOM_DELETE )
+test_equal( "sprintf with a format that has a delete routine", "7", sprintf( s, 7 ) )
+s = ""
+test_equal( "format with a delete routine deleted by derefs after sprintf", 1, delete_count() )
+
 s = {0}
 s[1] = delete_routine( 1, CUSTOM_DELETE )
 s[1] = 0
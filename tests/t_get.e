@@ -94,5 +94,34 @@ close(fn)
 
 delete_file( "get.txt" )
 
+test_equal("value() comments in a sequence", {GET_SUCCESS, {1, 2}}, value("{1, -- one\n 2 -- two\n}"))
+test_equal("value() comments in a sequence, long answer", {GET_SUCCESS, {1, 2}, 22, 0},
+	value("{1, -- one\n 2 -- two\n}", 1, GET_LONG_ANSWER))
+test_equal("value() only a comment", {GET_NOTHING, 0, 20, 2}, value("  -- only a comment\n", 1, GET_LONG_ANSWER))
+test_equal("value() leading and trailing whitespace", {GET_SUCCESS, {1, 2}, 7, 2}, value("  {1,2}  ", 1, GET_LONG_ANSWER))
+test_equal("value() escapes", {GET_SUCCESS, "a\tb\\c\"d\r\n"}, value(`"a\tb\\c\"d\r\n"`))
+test_equal("value() bad escape", {GET_FAIL, 0}, value(`"a\qb"`))
+test_equal("value() escaped character", {GET_SUCCESS, '\''}, value(`'\''`))
+test_equal("value() hex", {GET_SUCCESS, -255}, value("-#FF"))
+test_equal("value() integer", 1, integer(value("1234567")[2]))
+test_equal("value() whole decimal is an integer", 1, integer(value("12.000")[2]))
+test_true("value() decimal is rounded correctly", value("0.3")[2] = 3e-1)
+test_true("value() long decimal is rounded correctly",
+	value("3.14159265358979323846264338327950288")[2] = 3.14159265358979323846264338327950288e0)
+
+fn = open( "get.txt", "w" )
+puts(fn, "{1,2} 3.5\n-- last\n\"x\"")
+close(fn)
+
+fn = open( "get.txt", "r" )
+test_equal( "get sequence", { GET_SUCCESS, {1, 2}}, get( fn ) )
+test_equal( "get reads one character after a sequence", 6, where( fn ) )
+test_equal( "get number", { GET_SUCCESS, 3.5}, get( fn ) )
+test_equal( "get past a comment", { GET_SUCCESS, "x"}, get( fn ) )
+test_equal( "get at the end", { GET_EOF, 0}, get( fn ) )
+close(fn)
+
+delete_file( "get.txt" )
+
 test_report()
 
@@ -85,4 +85,49 @@ for i = 1 to length(hashalgo) do
 	end if
 end for
 
+ifdef BITS64 then
+	constant WY_SHIFT = 4
+elsedef
+	constant WY_SHIFT = power(2, 34)
+end ifdef
+
+constant DIGITS80 = "12345678901234567890123456789012345678901234567890123456789012345678901234567890"
+
+-- values from the wyhash test vectors
+test_equal("WYHASH of nothing", floor(#93228A4DE0EEC5A2 / WY_SHIFT), hash("", WYHASH))
+test_equal("WYHASH with a seed", floor(#A97F2F7B1D9B3314 / WY_SHIFT),
+	hash_final(hash_update(hash_init(WYHASH, 2), "abc")))
+test_equal("WYHASH over 48 bytes", floor(#6CC5EAB49A92D617 / WY_SHIFT),
+	hash_final(hash_update(hash_init(WYHASH, 6), DIGITS80)))
+
+sequence wy_state = hash_init()
+for i = 1 to length(s) by 7 do
+	integer j = i + 6
+	if j > length(s) then
+		j = length(s)
+	end if
+	wy_state = hash_update(wy_state, s[i..j])
+end for
+test_equal("WYHASH in pieces", hash(s, WYHASH), hash_final(wy_state))
+test_equal("WYHASH_SEEDED in pieces", hash(s, WYHASH_SEEDED),
+	hash_final(hash_update(hash_init(WYHASH_SEEDED), s)))
+test_true("WYHASH_SEEDED is an integer", integer(hash(s, WYHASH_SEEDED)))
+test_true("WYHASH is not negative", hash(s, WYHASH) >= 0 and hash(-s, WYHASH) >= 0)
+
+test_equal("WYHASH integer vs equivalent double", hash(5, WYHASH), hash(5.5 - 0.5, WYHASH))
+test_equal("WYHASH integer vs equivalent double in a sequence",
+	hash({1, "ab", 5}, WYHASH), hash({1, "ab", 5.5 - 0.5}, WYHASH))
+test_equal("WYHASH string vs equivalent doubles", hash("ab", WYHASH), hash({97.5 - 0.5, 98}, WYHASH))
+test_not_equal("WYHASH integer vs almost equivalent double", hash(5, WYHASH), hash(5.5 - 0.49, WYHASH))
+test_not_equal("WYHASH string vs nested string", hash("ab", WYHASH), hash({"ab"}, WYHASH))
+test_not_equal("WYHASH nesting", hash({{1}, 2}, WYHASH), hash({1, {2}}, WYHASH))
+
+ifdef BITS64 then
+	-- these differ only in the bits a long double has beyond a double
+	atom near1 = 1 + power(2, -60), nearer1 = 1 + power(2, -61)
+	test_not_equal("WYHASH long doubles", hash(near1, WYHASH), hash(nearer1, WYHASH))
+	test_not_equal("WYHASH long doubles in a sequence",
+		hash({near1}, WYHASH), hash({nearer1}, WYHASH))
+end ifdef
+
 test_report()
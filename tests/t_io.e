@@ -42,6 +42,10 @@ test_equal("read_lines() #7", "This is a file used for unit tests. Please", data
 test_equal("read_lines() #8", "Thank You!", data[9])
 close(tmp)
 
+data = read_lines("file.txt", 1)
+test_equal("read_lines() intern #1", 9, length(data))
+test_equal("read_lines() intern #2", "Thank You!", data[9])
+
 data = read_file("file.txt")
 test_equal("read_file() #1", data_length+new_line_count, length(data))
 test_equal("read_file() #2", "alter this file", data[52..66])
@@ -132,5 +132,43 @@ for i = 1 to 5 label "loop1" do
 end for
 test_pass("continue to parent loop, ticket:396")
 
+-- element updates with op= keep the element type of a sequence of integers
+sequence counts = repeat(0, 5)
+for i = 1 to 20 do
+	counts[remainder(i, 5) + 1] += i
+end for
+counts[4..5] = { 100, 200 }
+integer counts_total = 0
+for i = 1 to length(counts) do
+	counts_total += counts[i]
+end for
+test_equal( "sum of integers updated with +=", 422, counts_total )
+
+counts[1] += 0.5
+counts[2..3] += 0.25
+atom counts_sum = 0
+for i = 1 to length(counts) do
+	counts_sum += counts[i]
+end for
+test_equal( "sum after += stores doubles", 423, counts_sum )
+
+sequence par_x = { 1, 2.5, -3, 4 }, par_y = { 2, 2, 0.5, -8 }, par_r = repeat(0, 4)
+sequence par_shared = par_r
+with parallel
+for i = 1 to 4 do
+	par_r[i] = par_x[i] * par_y[i] + i / 2
+end for
+without parallel
+test_equal( "with parallel loop", { 2.5, 6, 0, -30 }, par_r )
+test_equal( "with parallel loop copies a shared target", repeat(0, 4), par_shared )
+
+par_x[3] = { 1 }
+with parallel
+for i = 1 to 3 do
+	par_r[i] = par_x[i] / par_y[i] + par_x[i]
+end for
+without parallel
+test_equal( "with parallel loop over a sequence element", { 1.5, 3.75, { 3 }, -30 }, par_r )
+
 test_report()
 
@@ -472,17 +472,26 @@ map:put(m1, "version", "4.0")
 map:put(m1, "genre", "programming language")
 map:put(m1, "crc", "4F71AE10")
 
--- Unsorted 
+-- Unsorted, in an order that changes from run to run
 map:for_each(m1, routine_id("Process_A"))
+sequence counts = {}
+for i = 1 to length(fer) do
+	counts &= fer[i][4]
+	fer[i] = fer[i][1..3]
+end for
+test_equal("for_each unsorted counts", {1, 2, 3, 4}, counts)
+test_equal("for_each unsorted", {
+	{"application", "Euphoria", 0},
+	{"crc", "4F71AE10", 0},
+	{"genre", "programming language", 0},
+	{"version", "4.0", 0}}, sort(fer))
+
+fer = {}
 -- Sorted
 map:for_each(m1, routine_id("Process_B"), "List of Items", 1)
 
 sequence efer = {
 --	{"The map is empty",0,0,0,0},
-	{"crc", "4F71AE10", 0, 1},
-	{"genre", "programming language", 0, 2},
-	{"version", "4.0", 0, 3},
-	{"application", "Euphoria", 0, 4},
 	{"START", "application", "Euphoria", "List of Items", 1},
 	{"application", "Euphoria", "List of Items", 1},
 	{"crc", "4F71AE10", "List of Items", 2},
@@ -341,4 +341,22 @@ end procedure
 bigmult64()
 end ifdef
 
+-- sums of integers whose ranges are known need no overflow check
+procedure ranged_sums()
+	integer total = 0
+	for i = 1 to 10 do
+		for j = -5 to 5 do
+			total = total + (i - j)
+		end for
+	end for
+	test_equal("ranged integer sums", 605, total)
+
+	atom big = 0
+	for i = 1073741822 to 1073741823 do
+		big = i + i
+	end for
+	test_equal("ranged sums past the 32-bit integer limit", 2147483646, big)
+end procedure
+ranged_sums()
+
 test_report()
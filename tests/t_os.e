@@ -13,5 +13,46 @@ test_equal("getenv() #5", -1, getenv("EUTEST_EXAMPLE"))
 
 test_true( "get_pid()", get_pid() > 0)
 
+sequence stats = heap_stats()
+test_equal("heap_stats() length", HEAP_PEAK_RSS, length(stats))
+test_equal("heap_stats() size classes", length(stats[HEAP_CLASS_SIZES]), length(stats[HEAP_CLASS_BLOCKS]))
+test_true("heap_stats() peak", stats[HEAP_PEAK_BYTES] >= stats[HEAP_LIVE_BYTES])
+sequence big_block = repeat(0, 100_000)
+test_true("heap_stats() large blocks", heap_stats()[HEAP_LARGE_BYTES] > stats[HEAP_LARGE_BYTES])
+big_block = {}
+
+test_equal("sample_allocations() default", 0, sample_allocations(1))
+for i = 1 to 10 do
+	big_block &= {repeat(i, i)}
+end for
+test_equal("sample_allocations() previous", 1, sample_allocations(0))
+sequence sites = allocation_sites(1)
+ifdef EUC then
+	test_equal("allocation_sites() translated", {}, sites)
+elsedef
+	test_true("allocation_sites()", length(sites) > 0)
+end ifdef
+test_equal("allocation_sites() cleared", {}, allocation_sites())
+
+-- reading the sites while every allocation is sampled
+integer site_shape = 1
+sample_allocations(1)
+for i = 1 to 50 do
+	big_block &= {sprintf("%d", i), repeat(i, i)}
+	sites = allocation_sites()
+	for j = 1 to length(sites) do
+		if length(sites[j]) != 5 or atom(sites[j][1]) or sites[j][4] < 1 then
+			site_shape = 0
+		end if
+	end for
+end for
+sample_allocations(0)
+test_true("allocation_sites() while sampling", site_shape)
+ifdef not EUC then
+	test_true("allocation_sites() while sampling found", length(sites) > 0)
+end ifdef
+big_block = {}
+sites = allocation_sites(1)
+
 test_report()
 
@@ -42,5 +42,19 @@ end if
 
 pipe:kill(p)
 
+p = pipe:exec(interpreter & " "& stdseq:join({"..","demo","pipe_sub.ex"},fs:SLASH), pipe:create())
+if atom(p) then
+	test_fail("pipe:exec #2")
+else
+	bytes = pipe:write(p[STDIN], message & "\n")
+	test_equal("pipe:wait exit status", 0, pipe:wait(p))
+	ifdef UNIX then
+		test_equal("pipe:wait on a finished process", -2, pipe:wait(p))
+	end ifdef
+	pipe:close(p[STDIN])
+	pipe:close(p[STDOUT])
+	pipe:close(p[STDERR])
+end if
+
 test_report()
 
@@ -33,6 +33,28 @@ include std/error.e
 id = routine_id("crash")
 test_equal( "forward, computed routine id included", id, fwd_id )
 
+test_equal( "computed qualified routine id", id, retname("error:", "crash") )
+test_equal( "computed routine id with no such routine", -1, retname("no_such_", "routine") )
+test_equal( "computed routine id with no such namespace", -1, retname("no_such:", "crash") )
+
+sequence names = { "foo", "bar", "baz", "crash", "error:crash", " error : crash " }
+sequence ids = repeat(0, length(names))
+for i = 1 to length(names) do
+	ids[i] = retname("", names[i])
+end for
+test_equal( "computed routine ids qualified and not", ids[4], ids[5] )
+test_equal( "computed routine id with spaces around the namespace", ids[4], ids[6] )
+test_not_equal( "computed routine ids of different routines", ids[1], ids[2] )
+integer same = 1
+for n = 1 to 100 do
+	for i = 1 to length(names) do
+		if retname("", names[i]) != ids[i] then
+			same = 0
+		end if
+	end for
+end for
+test_true( "computed routine ids keep the id first given", same )
+
 include routine_id.e
 
 test_report()
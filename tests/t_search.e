@@ -193,5 +193,34 @@ test_equal("lookup3c", {{3,2}, {3,1}, {2}} ,
   )
 
 
-test_report()
+sequence find_ints = repeat(7, 37)
+find_ints[37] = 9
+test_equal("find() integer at the end", 37, find(9, find_ints))
+test_equal("find() integer missing", 0, find(8, find_ints))
+find_ints[20] = sqrt(81) -- a double
+test_equal("find() integer equal to a double", 20, find(9, find_ints))
+find_ints[19] = {9}
+test_equal("find() integer past a sequence", 20, find(9, find_ints))
+test_equal("find() integer from a position", 37, find(9, find_ints, 21))
+test_equal("find() integer from past the end", 0, find(9, find_ints, 38))
+test_equal("find() double equal to an integer", 1, find(sqrt(49), find_ints))
+
+
+sequence match_text = repeat('a', 1000)
+match_text[900..902] = "aab"
+test_equal("match() short needle in long text", 900, match("aab", match_text))
+test_equal("match() short needle missing", 0, match("abb", match_text))
+test_equal("match() short needle from a position", 0, match("aab", match_text, 901))
+test_equal("match() long needle in long text", 860, match(repeat('a', 42) & 'b', match_text))
+test_equal("match() long needle missing", 0, match(repeat('a', 42) & "bb", match_text))
+test_equal("match() large integers", 3, match({-1, 1000, -1}, {-1, -1, -1, 1000, -1, 1000}))
+match_text[500] = sqrt(9409) -- a double equal to 'a'
+match_text[901] = sqrt(9409)
+test_equal("match() short needle over doubles", 900, match("aab", match_text))
+test_equal("match() long needle over doubles", 860, match(repeat('a', 42) & 'b', match_text))
+match_text[902] = {'b'}
+test_equal("match() needle past a sequence", 0, match("aab", match_text))
+test_equal("match() one integer", 500, match("a", match_text, 500))
+
 
+test_report()
@@ -80,6 +80,19 @@ test_equal("join() simple string default", "a b c", join({"a", "b", "c"}))
 test_equal("join() simple string", "a,b,c", join({"a", "b", "c"}, ","))
 test_equal("join() nested sequence", {"John", 0, "Doe"}, join({{"John"}, {"Doe"}}, 0))
 test_equal("join() empty", "123", join({"1","2","3"}, ""))
+test_equal("join() atoms and sequences", {1,0,'a','b',0,2}, join({1, "ab", 2}, 0))
+test_equal("join() one item", "abc", join({"abc"}, ","))
+test_equal("join() one atom", {5}, join({5}, ","))
+test_equal("join() no items", {}, join({}, ","))
+test_equal("split() delimiter at the ends", {"", "a", ""}, split(",a,", ','))
+test_equal("split() all delimiters no empty", {}, split(",,,", ',', 1))
+test_equal("split() limit and no empty", {"a", ",b,c"}, split(",a,,b,c", ',', 1, 2))
+test_equal("split() double delimiter", {{1}, {2}}, split({1, 0, 2}, 0.0))
+test_equal("split() empty delimiter limit at the end", {"1","2","3",""}, split("123", "",, 3))
+test_equal("split() long string", repeat("abc", 1000), split(repeat_pattern("abc,", 1000)[1..$-1], ','))
+test_equal("split_any() empty source", {""}, split_any("", ","))
+test_equal("split_any() doubles and sequences", {{1}, {2}, {3}}, split_any({1, 0.0, 2, {}, 3}, {0, {}}))
+test_equal("split_any() integers above 255", {"a", "b"}, split_any({'a', 1000, 'b'}, {1000}))
 
 test_equal("remove() integer sequence", {1,3}, remove({1,2,3}, 2))
 test_equal("remove() string", "Jon", remove("John", 3))
@@ -715,5 +728,56 @@ end procedure
 test_add_item()
 
 
-test_report()
+sequence cat_left = "", cat_right = "", cat_keep
+for i = 1 to 100 do
+	cat_right = cat_right & {i, i}
+	cat_left = {101 - i, 101 - i} & cat_left
+	if i = 50 then
+		cat_keep = cat_left
+	end if
+end for
+test_equal("repeated concat onto the right and left", cat_right, cat_left)
+test_equal("repeated concat leaves shared copies alone", 100, length(cat_keep))
+test_equal("repeated concat leaves shared copies alone 2", {51,51}, cat_keep[1..2])
+
+sequence interned = intern("in" & "terned")
+test_equal("intern string", "interned", interned)
+test_equal("intern same value", 0, compare(interned, intern("interned")))
+test_equal("intern atom", 4.5, intern(4.5))
+test_equal("intern nested shallow", {"a", {"b"}}, intern({"a", {"b"}}))
+test_equal("intern nested deep", {"a", {"b"}, 3}, intern({"a", {"b"}, 3}, 1))
+test_equal("split intern_parts", {"x", "y", "x"}, split("x,y,x", ',',,, 1))
+test_equal("split intern_parts empty delim", {"a", "b"}, split("ab", "",,, 1))
+interned = {}
+test_true("intern_purge releases unused strings", intern_purge() > 0)
+test_equal("intern_purge nothing left to release", 0, intern_purge())
+
+-- compare() and equal() skip long runs of equal elements several at a time
+sequence long1 = repeat(0, 1000), long2
+for i = 1 to length(long1) do
+	long1[i] = remainder(i, 251)
+end for
+long2 = long1
+test_equal("compare() long equal", 0, compare(long1, long2))
+test_true("equal() long equal", equal(long1, long2))
+long2[999] = 300
+test_equal("compare() long differs at the end <", -1, compare(long1, long2))
+test_equal("compare() long differs at the end >", 1, compare(long2, long1))
+test_false("equal() long differs at the end", equal(long1, long2))
+long2 = long1
+long2[517] = long1[517] + 0.0
+test_equal("compare() long integer and equal double", 0, compare(long1, long2))
+test_true("equal() long integer and equal double", equal(long1, long2))
+long2[517] = long1[517] - 5e-1
+test_equal("compare() long integer and smaller double", 1, compare(long1, long2))
+test_false("equal() long integer and smaller double", equal(long1, long2))
+long2 = long1
+long2[600] = {}
+test_equal("compare() long atom and sequence", -1, compare(long1, long2))
+test_equal("compare() long shorter", -1, compare(long1[1..$-1], long1))
+test_false("equal() long shorter", equal(long1[1..$-1], long1))
+test_equal("compare() long shorter but greater", 1, compare(long1[1..$-1] & 255, long1))
+test_true("equal() nested", equal({long1, "abc", 1.5}, {long1[1..$], "abc", 1.5}))
+test_false("equal() nested differs", equal({long1, "abc", 1.5}, {long1, "abd", 1.5}))
 
+test_report()
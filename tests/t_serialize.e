@@ -143,4 +143,7 @@ test_equal( "deserialize file long double", 1.3, deserialize( fh ) )
 close( fh )
 
 delete_file("cust.dat")
+
+sequence interned = deserialize(serialize({"red", {"red", 1}, "blue"}), 1, 1)
+test_equal("deserialize intern_strings", {{"red", {"red", 1}, "blue"}, 22}, interned)
 test_report()
@@ -3,6 +3,8 @@ include std/task.e
 include std/filesys.e
 include std/io.e
 include std/math.e
+include std/os.e
+include std/sequence.e
 
 sequence vResults
 sequence xResults
@@ -130,5 +132,59 @@ else
 end if
 
 test_equal("Tasks dir hash", xResults, vResults)
+
+test_equal("set_free_budget returns the default", 0, set_free_budget(100))
+sequence garbage = repeat(repeat(repeat(1.5, 10), 10), 100)
+garbage = {}
+task_yield()
+test_equal("set_free_budget returns the previous budget", 100, set_free_budget(0))
+
+-- each element holds its own double, so the doubles in use show what was released
+integer doubles_before = heap_stats()[HEAP_DOUBLES_IN_USE]
+garbage = repeat(0, 1000)
+for i = 1 to length(garbage) do
+	garbage[i] = {i + 0.5}
+end for
+set_free_budget(100)
+garbage = {}
+integer doubles_dropped = heap_stats()[HEAP_DOUBLES_IN_USE]
+test_true("set_free_budget defers the frees", doubles_dropped - doubles_before > 500)
+task_yield()
+integer doubles_yielded = heap_stats()[HEAP_DOUBLES_IN_USE]
+test_true("task_yield releases deferred frees", doubles_yielded < doubles_dropped)
+test_true("task_yield releases one slice", doubles_yielded - doubles_before > 500)
+set_free_budget(0)
+test_equal("set_free_budget(0) releases the rest", doubles_before, heap_stats()[HEAP_DOUBLES_IN_USE])
+
+test_equal("arena_begin depth", 1, arena_begin())
+sequence kept = {}
+for i = 1 to 1000 do
+	sequence temp = sprintf("request %d", i)
+	if i = 500 then
+		kept = temp
+	end if
+end for
+test_true("arena_end counts escaped values", arena_end() > 0)
+test_equal("escaped arena value survives the scope", "request 500", kept)
+kept &= " done"
+test_equal("escaped arena value can grow", "request 500 done", kept)
+
+-- the runtime's own caches must not keep values of a scope alive
+function arena_cached_values()
+	sequence key = sprintf("arena key %d", 7)
+	sequence key_format = repeat('%', 1) & "s=%d"
+	sequence line = sprintf(key_format, {intern(key), 1})
+	sequence keys = split(sprintf("a,%s,b", {key}), ',', , , 1)
+	return length(line) + length(keys)
+end function
+
+arena_begin()
+integer arena_live = arena_end()
+arena_begin()
+integer arena_result = arena_cached_values()
+test_equal("arena values aren't kept by runtime caches", arena_live, arena_end())
+test_equal("arena values are built", 16, arena_result)
+test_equal("interned arena value survives the scope", "arena key 7", intern(sprintf("arena key %d", 7)))
+test_equal("arena format can be used again", "x=2", sprintf("%s" & "=%d", {"x", 2}))
 test_report()
 
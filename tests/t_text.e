@@ -1,3 +1,6 @@
+include std/pretty.e
+include std/rand.e
+include std/scinot.e
 include std/text.e as seq
 include std/unittest.e
 
@@ -21,6 +24,10 @@ test_equal("trim() integer", "John\t\n", trim(" John\t\n ", 32))
 test_equal("trim() to empty", "", trim("  ", 32))
 test_equal("trim() almost empty", "a", trim(" a ", 32))
 test_equal("trim() nothing", "abcdef", trim("abcdef", 32))
+test_equal("trim() nested items", {{1}, 2, {1}}, trim({{}, 0.5, {1}, 2, {1}, {}}, {{}, 0.5}))
+test_equal("trim() long text", "x", trim(repeat(' ', 100) & 'x' & repeat('\t', 100)))
+test_equal("trim() index to empty", {4, 3}, trim("   ", 32, 1))
+test_equal("trim_tail() index to empty", 0, trim_tail("   ", 32, 1))
 
 test_equal("lower() zero", 0, lower(0))
 test_equal("lower() atom", 'a', lower('A'))
@@ -33,6 +40,10 @@ test_equal("upper() atom", 'A', upper('a'))
 test_equal("upper() letters only", "JOHN", upper("joHn"))
 test_equal("upper() mixed text", "JOHN 50 &%.", upper("joHn 50 &%."))
 test_equal("upper() with \\0", "ABC\0DEF", upper("abc" & 0 & "DEF"))
+test_equal("upper() floating number", {'A', 'B', 66.5, 'A' + 0.5}, upper({97.0, 'b', 66.5, 'a' + 0.5}))
+test_equal("upper() long text", repeat("ABC-XYZ @[`{", 20) & 0.5, upper(repeat("abc-xyz @[`{", 20) & 0.5))
+test_equal("lower() long nested", {repeat('z', 40) & "{}", {}, repeat('q', 33)}, lower({repeat('Z', 40) & "{}", {}, repeat('Q', 33)}))
+test_equal("lower() unchanged", "1234 abc", lower("1234 abc"))
 
 test_equal("escape() default", "John \\\"Mc\\\" Doe", escape("John \"Mc\" Doe"))
 test_equal("escape() non-standard", "\\$100\\.50", escape("$100.50", "$."))
@@ -41,9 +52,45 @@ test_equal("sprint() integer", "10", sprint(10))
 test_equal("sprint() float", "5.5", sprint(5.5))
 test_equal("sprint() sequence #1", "{1,{2},3,{}}", sprint({1,{2},3,{}}))
 test_equal("sprint() sequence #2", "{97,98,99}", sprint("abc"))
+test_equal("sprint() fraction", "0.1", sprint(0.1))
+test_equal("sprint() more than ten digits", "123456789012.5", sprint(123456789012.5))
+test_equal("sprint() small", "{1e-05,-2.5e-300}", sprint({1e-5, -2.5e-300}))
+test_equal("sprint() big", "1e+100", sprint(1e100))
+test_equal("pretty_sprint() fraction", "0.1", pretty_sprint(0.1))
+test_equal("pretty_sprint() same as sprint()", sprint(1/3), pretty_sprint(1/3))
+
+-- the digits sprint() shows read back as the same atom
+set_rand(42)
+integer round_trip_failures = 0
+for i = 1 to 300 do
+	atom x = rand(1_000_000_000) / rand(1_000_000_000) * power(10, rand(61) - 31)
+	sequence text = sprint(x)
+	if not find('e', text) then
+		text &= "e0"
+	end if
+	if scientific_to_atom(text) != x then
+		round_trip_failures += 1
+	end if
+end for
+test_equal("sprint() round trip", 0, round_trip_failures)
 test_equal("sprintf() integer", "i=1", sprintf("i=%d", {1}))
 test_equal("sprintf() float", "i=5.5", sprintf("i=%.1f", {5.5}))
 test_equal("sprintf() percent", "%", sprintf("%%", {}))
+test_equal("sprintf() negative integer", "-4611686018427387904", sprintf("%d", -power(2, 62)))
+test_equal("sprintf() width and plain", "[  -7|ab|x]", sprintf("[%4d|%s|%s]", {-7, "ab", 'x'}))
+test_equal("sprintf() atom for each", "3 3", sprintf("%d %d", 3))
+sequence long_format = repeat('.', 300) & "%d"
+test_equal("sprintf() long text", repeat('.', 300) & "12", sprintf(long_format, 12))
+test_equal("sprintf() same format again", repeat('.', 300) & "-1", sprintf(long_format, -1))
+long_format[1] = '%'
+long_format[2] = 's'
+test_equal("sprintf() changed format", "a" & repeat('.', 298) & "5", sprintf(long_format, {"a", 5}))
+sequence long_result = ""
+for i = 1 to 1000 do
+	long_result = sprintf("%s%d,", {long_result, i})
+end for
+test_equal("sprintf() growing result", 3893, length(long_result))
+test_equal("sprintf() text after a 0", "a1", sprintf("a\0b%d", 1))
 
 
 -- proper
@@ -144,6 +191,21 @@ test_equal("Encoding uppercase #6", {#80,#81,#82,#83,#84,#85,#86,#87,#88,#89,#8A
                               
 set_encoding_properties("", "", "")
 
+-- a "UTF-8" encoding reads byte strings as UTF-8
+set_encoding_properties("UTF-8", {'a', 'b', #E4, #3B1}, {'A', 'B', #C4, #391})
+test_equal("Encoding uppercase UTF-8", {'A', 'B', ' ', #C3, #84, ' ', #CE, #91, #FF},
+                                      upper({'a', 'b', ' ', #C3, #A4, ' ', #CE, #B1, #FF}))
+test_equal("Encoding lowercase UTF-8", {'a', 'b', #C3, #A4}, lower({'A', 'B', #C3, #84}))
+test_equal("Encoding uppercase code points", {#C4, #391, 'c'}, upper({#E4, #3B1, 'c'}))
+set_encoding_properties("", "", "")
+
+-- any other encoding changes each element on its own, as mapping() does
+set_encoding_properties("Unicode", {'a', 'b', #E4, #3B1}, {'A', 'B', #C4, #391})
+test_equal("Encoding uppercase Unicode bytes", {#C4}, upper({#E4}))
+test_equal("Encoding uppercase Unicode bytes one by one", {'A', #C3, #A4, #C4}, upper({'a', #C3, #A4, #E4}))
+test_equal("Encoding lowercase Unicode bytes", {'a', #E4, #C3, #84}, lower({'A', #C4, #C3, #84}))
+set_encoding_properties("", "", "")
+
 
 -- quote()
 test_equal("quote #1", "\"The small man\"", quote("The small man"))